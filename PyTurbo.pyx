@@ -1,4 +1,6 @@
 # distutils: language = c++
+# distutils: extra_compile_args = -pthread -std=c++14
+# distutils: extra_link_args = -pthread
 
 # Copyright 2019 Free Software Foundation, Inc.
 #
@@ -18,7 +20,57 @@
 # Boston, MA 02110-1301, USA.
 
 
+from cython.operator cimport dereference
+from libc.string cimport memcpy
+from libcpp cimport bool
+from libcpp.complex cimport complex as cpp_complex
+from libcpp.string cimport string
 from libcpp.vector cimport vector
+from libc.stdint cimport uint64_t
+
+cdef extern from "perf_counters.h":
+    cdef enum:
+        PERF_BINDING
+        PERF_N_COUNTERS
+    cppclass perf_counters:
+        uint64_t get(int)
+        void reset()
+        @staticmethod
+        const char* name(int)
+    uint64_t perf_clock()
+    void perf_elapsed(perf_counters&, int, uint64_t)
+    bool cpp_perf_counters_enabled "perf_counters_enabled"()
+
+cdef extern from "metric_storage.cc":
+    pass
+
+cdef extern from "metric_storage.h":
+    ctypedef enum metric_storage:
+        METRIC_FLOAT32
+        METRIC_FLOAT16
+        METRIC_BFLOAT16
+        METRIC_INT16
+
+cdef extern from "puncturing_pattern.cc":
+    pass
+
+cdef extern from "puncturing_pattern.h":
+    cppclass puncturing_pattern:
+        puncturing_pattern(int, vector[int]) except +
+        size_t get_n_soft(size_t)
+        void puncture[T](const T*, size_t, T*)
+        int get_n()
+        size_t get_period()
+
+cdef extern from "crc.cc":
+    pass
+
+cdef extern from "crc.h":
+    cppclass crc:
+        crc(int, uint64_t, uint64_t, uint64_t) except +
+        uint64_t compute(const unsigned int*, size_t)
+        bool check(const unsigned int*, size_t)
+        int get_width()
 
 cdef extern from "viterbi.cc":
     pass
@@ -27,6 +79,12 @@ cdef extern from "viterbi.h":
     cppclass viterbi:
         viterbi(int, int, int, vector[int], vector[int]) except +
         void viterbi_algorithm(int K, int S0, int, const float*, unsigned int*)
+        void viterbi_algorithm_punctured(int, int, int, const float*, const puncturing_pattern&, unsigned int*) except +
+        int viterbi_algorithm_list(int, int, int, const float*, int, unsigned int*, float*) except +
+        int viterbi_algorithm_list_crc(int, int, int, const float*, int, const crc&, size_t, unsigned int*) except +
+        void set_vectorized(bool)
+        bool get_vectorized()
+        perf_counters& get_perf_counters()
         int get_I()
         int get_S()
         int get_O()
@@ -38,6 +96,13 @@ cdef extern from "log_bcjr_base.h":
     cppclass log_bcjr_base:
         log_bcjr_base(int, int, int, vector[int], vector[int]) except +
         void log_bcjr_algorithm(vector[float], vector[float], vector[float], vector[float])
+        void set_bidirectional(bool)
+        bool get_bidirectional()
+        void set_storage(metric_storage) except +
+        metric_storage get_storage()
+        void compute_llr(vector[float], vector[float])
+        perf_counters& get_perf_counters()
+        void log_bcjr_algorithm_punctured(vector[float], vector[float], vector[float], const puncturing_pattern&, size_t, vector[float]) except +
         int get_I()
         int get_S()
         int get_O()
@@ -54,7 +119,233 @@ cdef extern from "max_log_bcjr.h":
         @staticmethod
         float max(const float*, size_t)
 
+cdef extern from "prob_bcjr.cc":
+    pass
+
+cdef extern from "prob_bcjr.h":
+    cppclass prob_bcjr(log_bcjr_base):
+        prob_bcjr(int, int, int, vector[int], vector[int]) except +
+
+cdef extern from "log_bcjr_stream.cc":
+    pass
+
+cdef extern from "log_bcjr_stream.h":
+    cppclass log_bcjr_stream:
+        log_bcjr_stream(log_bcjr_base&, vector[float], size_t, bool) except +
+        void push(const float*, size_t, vector[float]&)
+        void flush(vector[float], vector[float], vector[float]&) except +
+        void reset(vector[float]) except +
+        size_t get_pending()
+        size_t get_lookahead()
+
+cdef extern from "isi_trellis.cc":
+    pass
+
+cdef extern from "isi_trellis.h":
+    cppclass isi_trellis:
+        isi_trellis(vector[cpp_complex[float]], vector[cpp_complex[float]]) except +
+        void branch_metrics(const cpp_complex[float]*, size_t, float, const float*, float*)
+        void branch_metrics_llr(const cpp_complex[float]*, size_t, float, const float*, float*) except +
+        int get_I()
+        int get_S()
+        int get_O()
+        vector[int]& get_NS()
+        vector[int]& get_OS()
+
+cdef extern from "conv_trellis.cc":
+    pass
+
+cdef extern from "conv_trellis.h":
+    cppclass conv_trellis:
+        conv_trellis(vector[int], int) except +
+        int get_I()
+        int get_S()
+        int get_O()
+        int get_nu()
+        vector[int]& get_NS()
+        vector[int]& get_OS()
+
+cdef extern from "fixed_decoders.cc":
+    pass
+
+cdef extern from "fixed_decoders.h":
+    vector[string] cpp_fixed_code_names "fixed_code_names"()
+    viterbi* make_fixed_viterbi(string) except +
+    log_bcjr_base* make_fixed_bcjr(string, bool) except +
+
+cdef extern from "file_decoder.cc":
+    pass
+
+cdef extern from "file_decoder.h":
+    cppclass file_decoder:
+        file_decoder(size_t, size_t) except +
+        size_t decode(log_bcjr_base&, vector[float], vector[float], string, string, bool) except + nogil
+        size_t decode(viterbi&, int, int, string, string) except + nogil
+        size_t get_block_len()
+        size_t get_queue_depth()
+
 import numpy
+import os
+
+def perf_counters_enabled():
+    return cpp_perf_counters_enabled()
+
+def fixed_code_names():
+    return [name.decode() for name in cpp_fixed_code_names()]
+
+cdef _perf_counters_dict(perf_counters &perf):
+    return {perf_counters.name(c).decode(): perf.get(c) for c in range(PERF_N_COUNTERS)}
+
+_metric_storages = {'float32': METRIC_FLOAT32, 'float16': METRIC_FLOAT16,
+        'bfloat16': METRIC_BFLOAT16, 'int16': METRIC_INT16}
+
+cdef metric_storage _metric_storage(name) except *:
+    if name not in _metric_storages:
+        raise ValueError('storage must be one of ' + ', '.join(_metric_storages))
+
+    return _metric_storages[name]
+
+cdef _metric_storage_name(metric_storage storage):
+    for name in _metric_storages:
+        if _metric_storages[name] == storage:
+            return name
+
+cdef _vector_to_numpy(vector[float] &vec):
+    ret = numpy.empty(vec.size(), dtype=numpy.float32)
+    cdef float[::1] ret_view = ret
+
+    if vec.size() > 0:
+        memcpy(&ret_view[0], vec.data(), vec.size()*sizeof(float))
+
+    return ret
+
+cdef class PyPuncturingPattern:
+    cdef int n
+    cdef puncturing_pattern* cpp_pattern
+
+    def __cinit__(self, int n, vector[int] pattern):
+        self.cpp_pattern = new puncturing_pattern(n, pattern)
+        self.n = self.cpp_pattern.get_n()
+
+    def __dealloc__(self):
+        del self.cpp_pattern
+
+    def get_n_soft(self, size_t K):
+        return self.cpp_pattern.get_n_soft(K)
+
+    def get_n(self):
+        return self.n
+
+    def get_period(self):
+        return self.cpp_pattern.get_period()
+
+    def puncture(self, coded):
+        cdef float[::1] _in = numpy.ascontiguousarray(coded, dtype=numpy.float32)
+        cdef size_t K = _in.shape[0]//self.n
+        cdef float[::1] _out = numpy.zeros(self.cpp_pattern.get_n_soft(K), dtype=numpy.float32)
+
+        if _out.shape[0] > 0:
+            self.cpp_pattern.puncture(&_in[0], K, &_out[0])
+
+        return numpy.asarray(_out)
+
+cdef log_bcjr_base* _cpp_bcjr(decoder) except NULL:
+    if isinstance(decoder, PyLogBCJR):
+        return (<PyLogBCJR>decoder).cpp_log_bcjr
+    elif isinstance(decoder, PyMaxLogBCJR):
+        return (<PyMaxLogBCJR>decoder).cpp_max_log_bcjr
+    elif isinstance(decoder, PyProbBCJR):
+        return (<PyProbBCJR>decoder).cpp_prob_bcjr
+    elif isinstance(decoder, PyFixedBCJR):
+        return (<PyFixedBCJR>decoder).cpp_bcjr
+    else:
+        raise TypeError('decoder must be a PyLogBCJR, PyMaxLogBCJR, PyProbBCJR or PyFixedBCJR')
+
+cdef viterbi* _cpp_viterbi(decoder) except NULL:
+    if isinstance(decoder, PyViterbi):
+        return (<PyViterbi>decoder).cpp_viterbi
+    elif isinstance(decoder, PyFixedViterbi):
+        return (<PyFixedViterbi>decoder).cpp_viterbi
+    else:
+        raise TypeError('decoder must be a PyViterbi or PyFixedViterbi')
+
+cdef class PyCRC:
+    cdef crc* cpp_crc
+
+    def __cinit__(self, int width, uint64_t poly, uint64_t init=0, uint64_t xorout=0):
+        self.cpp_crc = new crc(width, poly, init, xorout)
+
+    def __dealloc__(self):
+        del self.cpp_crc
+
+    def compute(self, bits):
+        cdef unsigned int[::1] _bits = numpy.ascontiguousarray(bits, dtype=numpy.uint32)
+
+        if _bits.shape[0] == 0:
+            return self.cpp_crc.compute(NULL, 0)
+
+        return self.cpp_crc.compute(&_bits[0], _bits.shape[0])
+
+    def check(self, bits):
+        cdef unsigned int[::1] _bits = numpy.ascontiguousarray(bits, dtype=numpy.uint32)
+
+        if _bits.shape[0] == 0:
+            return False
+
+        return self.cpp_crc.check(&_bits[0], _bits.shape[0])
+
+    def append(self, bits):
+        cdef int width = self.cpp_crc.get_width()
+        cdef uint64_t value = self.compute(bits)
+        crc_bits = [(value >> (width-1-b)) & 1 for b in range(width)]
+
+        return numpy.concatenate((numpy.asarray(bits, dtype=numpy.uint16),
+            numpy.array(crc_bits, dtype=numpy.uint16)))
+
+    def get_width(self):
+        return self.cpp_crc.get_width()
+
+cdef _viterbi_list(viterbi *dec, S0, SK, float[::1] _in, int L):
+    cdef int K = _in.shape[0]//dec.get_O()
+    cdef unsigned int[:, ::1] _out
+    cdef float[::1] _metrics
+    cdef int n
+
+    if L < 1:
+        raise ValueError('L must be strictly positive')
+    if K == 0:
+        return (numpy.zeros((1, 0), dtype=numpy.uint16),
+                numpy.zeros(1, dtype=numpy.float32))
+
+    _out = numpy.zeros((L, K), dtype=numpy.uint32)
+    _metrics = numpy.zeros(L, dtype=numpy.float32)
+    n = dec.viterbi_algorithm_list(K, S0, SK, &_in[0], L, &_out[0, 0],
+            &_metrics[0])
+
+    cdef uint64_t t_start = perf_clock()
+    ret = (numpy.asarray(_out[:n], dtype=numpy.uint16),
+            numpy.asarray(_metrics[:n]))
+    perf_elapsed(dec.get_perf_counters(), PERF_BINDING, t_start)
+
+    return ret
+
+cdef _viterbi_list_crc(viterbi *dec, S0, SK, float[::1] _in, int L,
+        PyCRC check, size_t n_checked):
+    cdef int K = _in.shape[0]//dec.get_O()
+    cdef unsigned int[::1] _out = numpy.zeros(K, dtype=numpy.uint32)
+    cdef int rank
+
+    if K == 0:
+        raise ValueError('_in must contain at least one time index')
+
+    rank = dec.viterbi_algorithm_list_crc(K, S0, SK, &_in[0], L,
+            dereference(check.cpp_crc), n_checked, &_out[0])
+
+    cdef uint64_t t_start = perf_clock()
+    ret = numpy.asarray(_out, dtype=numpy.uint16)
+    perf_elapsed(dec.get_perf_counters(), PERF_BINDING, t_start)
+
+    return ret, rank
 
 cdef class PyViterbi:
     cdef int I, S, O
@@ -75,7 +366,49 @@ cdef class PyViterbi:
 
         self.cpp_viterbi.viterbi_algorithm(K, S0, SK, &_in[0], &_out[0])
 
-        return numpy.asarray(_out, dtype=numpy.uint16)
+        cdef uint64_t t_start = perf_clock()
+        ret = numpy.asarray(_out, dtype=numpy.uint16)
+        perf_elapsed(self.cpp_viterbi.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def viterbi_algorithm_punctured(self, S0, SK, float[::1] llr,
+            PyPuncturingPattern pattern, int K):
+        cdef unsigned int[::1] _out = numpy.zeros(K, dtype=numpy.uint32)
+
+        if llr.shape[0] < pattern.get_n_soft(K):
+            raise ValueError('llr is too short for K trellis steps')
+        if K == 0:
+            return numpy.asarray(_out, dtype=numpy.uint16)
+
+        self.cpp_viterbi.viterbi_algorithm_punctured(K, S0, SK, &llr[0],
+                dereference(pattern.cpp_pattern), &_out[0])
+
+        cdef uint64_t t_start = perf_clock()
+        ret = numpy.asarray(_out, dtype=numpy.uint16)
+        perf_elapsed(self.cpp_viterbi.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def viterbi_algorithm_list(self, S0, SK, float[::1] _in, int L):
+        return _viterbi_list(self.cpp_viterbi, S0, SK, _in, L)
+
+    def viterbi_algorithm_list_crc(self, S0, SK, float[::1] _in, int L,
+            PyCRC check, size_t n_checked=0):
+        return _viterbi_list_crc(self.cpp_viterbi, S0, SK, _in, L, check,
+                n_checked)
+
+    def set_vectorized(self, bool vectorized):
+        self.cpp_viterbi.set_vectorized(vectorized)
+
+    def get_vectorized(self):
+        return self.cpp_viterbi.get_vectorized()
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_viterbi.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_viterbi.get_perf_counters().reset()
 
 cdef class PyLogBCJR:
     cdef int I, S, O
@@ -96,12 +429,57 @@ cdef class PyLogBCJR:
 
         return log_bcjr.max_star(&vec[0], n_ele)
 
-    def log_bcjr_algorithm(self, vector[float] &A0, vector[float] &BK, vector[float] &_in):
+    def log_bcjr_algorithm(self, A0, BK, _in):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _in_vec = _in
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_log_bcjr.log_bcjr_algorithm(_A0, _BK, _in_vec, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def log_bcjr_algorithm_punctured(self, A0, BK, llr, PyPuncturingPattern pattern,
+            size_t K):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _llr = llr
         cdef vector[float] _out
+        perf_elapsed(self.cpp_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_log_bcjr.log_bcjr_algorithm_punctured(_A0, _BK, _llr,
+                dereference(pattern.cpp_pattern), K, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def set_bidirectional(self, bool bidirectional):
+        self.cpp_log_bcjr.set_bidirectional(bidirectional)
 
-        self.cpp_log_bcjr.log_bcjr_algorithm(A0, BK, _in, _out)
+    def get_bidirectional(self):
+        return self.cpp_log_bcjr.get_bidirectional()
 
-        return numpy.asarray(_out, dtype=numpy.float32)
+    def set_storage(self, storage):
+        self.cpp_log_bcjr.set_storage(_metric_storage(storage))
+
+    def get_storage(self):
+        return _metric_storage_name(self.cpp_log_bcjr.get_storage())
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_log_bcjr.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_log_bcjr.get_perf_counters().reset()
 
 cdef class PyMaxLogBCJR:
     cdef int I, S, O
@@ -122,9 +500,440 @@ cdef class PyMaxLogBCJR:
 
         return max_log_bcjr.max(&vec[0], n_ele)
 
-    def log_bcjr_algorithm(self, vector[float] &A0, vector[float] &BK, vector[float] &_in):
+    def log_bcjr_algorithm(self, A0, BK, _in):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _in_vec = _in
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_max_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_max_log_bcjr.log_bcjr_algorithm(_A0, _BK, _in_vec, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_max_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def log_bcjr_algorithm_punctured(self, A0, BK, llr, PyPuncturingPattern pattern,
+            size_t K):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _llr = llr
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_max_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_max_log_bcjr.log_bcjr_algorithm_punctured(_A0, _BK, _llr,
+                dereference(pattern.cpp_pattern), K, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_max_log_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def set_bidirectional(self, bool bidirectional):
+        self.cpp_max_log_bcjr.set_bidirectional(bidirectional)
+
+    def get_bidirectional(self):
+        return self.cpp_max_log_bcjr.get_bidirectional()
+
+    def set_storage(self, storage):
+        self.cpp_max_log_bcjr.set_storage(_metric_storage(storage))
+
+    def get_storage(self):
+        return _metric_storage_name(self.cpp_max_log_bcjr.get_storage())
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_max_log_bcjr.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_max_log_bcjr.get_perf_counters().reset()
+
+cdef class PyProbBCJR:
+    cdef int I, S, O
+    cdef prob_bcjr* cpp_prob_bcjr
+
+    def __cinit__(self, int I, int S, int O, vector[int] NS, vector[int] OS):
+        self.cpp_prob_bcjr= new prob_bcjr(I, S, O, NS, OS)
+        self.I = self.cpp_prob_bcjr.get_I()
+        self.S = self.cpp_prob_bcjr.get_S()
+        self.O = self.cpp_prob_bcjr.get_O()
+
+    def __dealloc__(self):
+        del self.cpp_prob_bcjr
+
+    def log_bcjr_algorithm(self, A0, BK, _in):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _in_vec = _in
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_prob_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_prob_bcjr.log_bcjr_algorithm(_A0, _BK, _in_vec, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_prob_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def log_bcjr_algorithm_punctured(self, A0, BK, llr, PyPuncturingPattern pattern,
+            size_t K):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _llr = llr
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_prob_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_prob_bcjr.log_bcjr_algorithm_punctured(_A0, _BK, _llr,
+                dereference(pattern.cpp_pattern), K, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_prob_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def set_bidirectional(self, bool bidirectional):
+        self.cpp_prob_bcjr.set_bidirectional(bidirectional)
+
+    def get_bidirectional(self):
+        return self.cpp_prob_bcjr.get_bidirectional()
+
+    def set_storage(self, storage):
+        self.cpp_prob_bcjr.set_storage(_metric_storage(storage))
+
+    def get_storage(self):
+        return _metric_storage_name(self.cpp_prob_bcjr.get_storage())
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_prob_bcjr.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_prob_bcjr.get_perf_counters().reset()
+
+cdef class PyBCJRStream:
+    cdef int O
+    cdef object decoder
+    cdef log_bcjr_stream* cpp_stream
+
+    def __cinit__(self, decoder, vector[float] A0, size_t lookahead, bool llr=False):
+        cdef log_bcjr_base* cpp_dec = _cpp_bcjr(decoder)
+
+        #Keep a reference on the decoder, which must outlive the stream
+        self.decoder = decoder
+        self.O = cpp_dec.get_O()
+        self.cpp_stream = new log_bcjr_stream(dereference(cpp_dec), A0, lookahead, llr)
+
+    def __dealloc__(self):
+        del self.cpp_stream
+
+    def push(self, float[::1] _in):
+        cdef size_t K = _in.shape[0]//self.O
+        cdef vector[float] _out
+
+        if _in.shape[0] % self.O != 0:
+            raise ValueError('_in must contain a whole number of time indexes')
+        if K > 0:
+            self.cpp_stream.push(&_in[0], K, _out)
+
+        return _vector_to_numpy(_out)
+
+    def flush(self, vector[float] BK, vector[float] A0):
+        cdef vector[float] _out
+
+        self.cpp_stream.flush(BK, A0, _out)
+
+        return _vector_to_numpy(_out)
+
+    def reset(self, vector[float] A0):
+        self.cpp_stream.reset(A0)
+
+    def get_pending(self):
+        return self.cpp_stream.get_pending()
+
+    def get_lookahead(self):
+        return self.cpp_stream.get_lookahead()
+
+cdef class PyFileDecoder:
+    cdef file_decoder* cpp_file_decoder
+
+    def __cinit__(self, size_t block_len, size_t queue_depth=4):
+        self.cpp_file_decoder = new file_decoder(block_len, queue_depth)
+
+    def __dealloc__(self):
+        del self.cpp_file_decoder
+
+    def decode_bcjr(self, decoder, vector[float] A0, vector[float] BK,
+            in_path, out_path, bool llr=True):
+        cdef log_bcjr_base* cpp_dec = _cpp_bcjr(decoder)
+        cdef string _in_path = os.fsencode(in_path)
+        cdef string _out_path = os.fsencode(out_path)
+        cdef size_t K
+
+        with nogil:
+            K = self.cpp_file_decoder.decode(dereference(cpp_dec), A0, BK,
+                    _in_path, _out_path, llr)
+
+        return K
+
+    def decode_viterbi(self, decoder, int S0, int SK, in_path, out_path):
+        cdef viterbi* cpp_dec = _cpp_viterbi(decoder)
+        cdef string _in_path = os.fsencode(in_path)
+        cdef string _out_path = os.fsencode(out_path)
+        cdef size_t K
+
+        with nogil:
+            K = self.cpp_file_decoder.decode(dereference(cpp_dec), S0, SK,
+                    _in_path, _out_path)
+
+        return K
+
+    def get_block_len(self):
+        return self.cpp_file_decoder.get_block_len()
+
+    def get_queue_depth(self):
+        return self.cpp_file_decoder.get_queue_depth()
+
+cdef class PyConvTrellis:
+    cdef int I, S, O
+    cdef conv_trellis* cpp_conv_trellis
+
+    def __cinit__(self, vector[int] generators, int feedback=0):
+        self.cpp_conv_trellis = new conv_trellis(generators, feedback)
+        self.I = self.cpp_conv_trellis.get_I()
+        self.S = self.cpp_conv_trellis.get_S()
+        self.O = self.cpp_conv_trellis.get_O()
+
+    def __dealloc__(self):
+        del self.cpp_conv_trellis
+
+    def get_I(self):
+        return self.I
+
+    def get_S(self):
+        return self.S
+
+    def get_O(self):
+        return self.O
+
+    def get_nu(self):
+        return self.cpp_conv_trellis.get_nu()
+
+    def get_NS(self):
+        return self.cpp_conv_trellis.get_NS()
+
+    def get_OS(self):
+        return self.cpp_conv_trellis.get_OS()
+
+cdef class PyFixedViterbi:
+    cdef int I, S, O
+    cdef object name
+    cdef viterbi* cpp_viterbi
+
+    def __cinit__(self, name):
+        self.cpp_viterbi = make_fixed_viterbi(name.encode())
+        self.name = name
+        self.I = self.cpp_viterbi.get_I()
+        self.S = self.cpp_viterbi.get_S()
+        self.O = self.cpp_viterbi.get_O()
+
+    def __dealloc__(self):
+        del self.cpp_viterbi
+
+    def viterbi_algorithm(self, S0, SK, float[::1] _in):
+        cdef int K = _in.shape[0]//self.O
+        cdef unsigned int[::1] _out = numpy.zeros(K, dtype=numpy.uint32)
+
+        if K > 0:
+            self.cpp_viterbi.viterbi_algorithm(K, S0, SK, &_in[0], &_out[0])
+
+        cdef uint64_t t_start = perf_clock()
+        ret = numpy.asarray(_out, dtype=numpy.uint16)
+        perf_elapsed(self.cpp_viterbi.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def viterbi_algorithm_list(self, S0, SK, float[::1] _in, int L):
+        return _viterbi_list(self.cpp_viterbi, S0, SK, _in, L)
+
+    def viterbi_algorithm_list_crc(self, S0, SK, float[::1] _in, int L,
+            PyCRC check, size_t n_checked=0):
+        return _viterbi_list_crc(self.cpp_viterbi, S0, SK, _in, L, check,
+                n_checked)
+
+    def get_name(self):
+        return self.name
+
+    def get_I(self):
+        return self.I
+
+    def get_S(self):
+        return self.S
+
+    def get_O(self):
+        return self.O
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_viterbi.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_viterbi.get_perf_counters().reset()
+
+cdef class PyFixedBCJR:
+    cdef int I, S, O
+    cdef object name
+    cdef log_bcjr_base* cpp_bcjr
+
+    def __cinit__(self, name, bool max_log=False):
+        self.cpp_bcjr = make_fixed_bcjr(name.encode(), max_log)
+        self.name = name
+        self.I = self.cpp_bcjr.get_I()
+        self.S = self.cpp_bcjr.get_S()
+        self.O = self.cpp_bcjr.get_O()
+
+    def __dealloc__(self):
+        del self.cpp_bcjr
+
+    def log_bcjr_algorithm(self, A0, BK, _in):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _in_vec = _in
         cdef vector[float] _out
+        perf_elapsed(self.cpp_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_bcjr.log_bcjr_algorithm(_A0, _BK, _in_vec, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def log_bcjr_algorithm_punctured(self, A0, BK, llr, PyPuncturingPattern pattern,
+            size_t K):
+        cdef uint64_t t_start = perf_clock()
+        cdef vector[float] _A0 = A0
+        cdef vector[float] _BK = BK
+        cdef vector[float] _llr = llr
+        cdef vector[float] _out
+        perf_elapsed(self.cpp_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        self.cpp_bcjr.log_bcjr_algorithm_punctured(_A0, _BK, _llr,
+                dereference(pattern.cpp_pattern), K, _out)
+
+        t_start = perf_clock()
+        ret = _vector_to_numpy(_out)
+        perf_elapsed(self.cpp_bcjr.get_perf_counters(), PERF_BINDING, t_start)
+
+        return ret
+
+    def get_name(self):
+        return self.name
+
+    def get_I(self):
+        return self.I
+
+    def get_S(self):
+        return self.S
+
+    def get_O(self):
+        return self.O
+
+    def set_bidirectional(self, bool bidirectional):
+        self.cpp_bcjr.set_bidirectional(bidirectional)
+
+    def get_bidirectional(self):
+        return self.cpp_bcjr.get_bidirectional()
+
+    def set_storage(self, storage):
+        self.cpp_bcjr.set_storage(_metric_storage(storage))
+
+    def get_storage(self):
+        return _metric_storage_name(self.cpp_bcjr.get_storage())
+
+    def get_perf_counters(self):
+        return _perf_counters_dict(self.cpp_bcjr.get_perf_counters())
+
+    def reset_perf_counters(self):
+        self.cpp_bcjr.get_perf_counters().reset()
+
+cdef class PyISITrellis:
+    cdef int I, S, O
+    cdef isi_trellis* cpp_isi_trellis
+
+    def __cinit__(self, taps, constellation):
+        cdef vector[cpp_complex[float]] _taps
+        cdef vector[cpp_complex[float]] _constellation
+
+        for h in numpy.asarray(taps, dtype=numpy.complex64):
+            _taps.push_back(cpp_complex[float](h.real, h.imag))
+        for c in numpy.asarray(constellation, dtype=numpy.complex64):
+            _constellation.push_back(cpp_complex[float](c.real, c.imag))
+
+        self.cpp_isi_trellis = new isi_trellis(_taps, _constellation)
+        self.I = self.cpp_isi_trellis.get_I()
+        self.S = self.cpp_isi_trellis.get_S()
+        self.O = self.cpp_isi_trellis.get_O()
+
+    def __dealloc__(self):
+        del self.cpp_isi_trellis
+
+    def get_I(self):
+        return self.I
+
+    def get_S(self):
+        return self.S
+
+    def get_O(self):
+        return self.O
+
+    def get_NS(self):
+        return self.cpp_isi_trellis.get_NS()
+
+    def get_OS(self):
+        return self.cpp_isi_trellis.get_OS()
+
+    def branch_metrics(self, r, float sigma2, apriori=None):
+        cdef float complex[::1] _r = numpy.ascontiguousarray(r, dtype=numpy.complex64)
+        cdef size_t K = _r.shape[0]
+        cdef float[::1] _apriori
+        cdef const float* apriori_ptr = NULL
+        cdef float[::1] _out = numpy.zeros(K*self.O, dtype=numpy.float32)
+
+        if K == 0:
+            return numpy.asarray(_out)
+
+        if apriori is not None:
+            _apriori = numpy.ascontiguousarray(apriori, dtype=numpy.float32).flatten()
+            if _apriori.shape[0] != K*self.I:
+                raise ValueError('apriori must have I*K elements')
+            apriori_ptr = &_apriori[0]
+
+        self.cpp_isi_trellis.branch_metrics(<cpp_complex[float]*>&_r[0], K, sigma2,
+                apriori_ptr, &_out[0])
+
+        return numpy.asarray(_out)
+
+    def branch_metrics_llr(self, r, float sigma2, llr):
+        cdef float complex[::1] _r = numpy.ascontiguousarray(r, dtype=numpy.complex64)
+        cdef size_t K = _r.shape[0]
+        cdef float[::1] _llr = numpy.ascontiguousarray(llr, dtype=numpy.float32).flatten()
+        cdef float[::1] _out = numpy.zeros(K*self.O, dtype=numpy.float32)
+
+        if _llr.shape[0] != K:
+            raise ValueError('llr must have K elements')
+
+        if K == 0:
+            return numpy.asarray(_out)
 
-        self.cpp_max_log_bcjr.log_bcjr_algorithm(A0, BK, _in, _out)
+        self.cpp_isi_trellis.branch_metrics_llr(<cpp_complex[float]*>&_r[0], K,
+                sigma2, &_llr[0], &_out[0])
 
-        return numpy.asarray(_out, dtype=numpy.float32)
+        return numpy.asarray(_out)
@@ -0,0 +1,94 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "conv_trellis.h"
+
+#include <algorithm>
+
+//! Parity of the bits of x.
+static inline int
+conv_parity(int x)
+{
+	int p = 0;
+
+	for( ; x != 0 ; x >>= 1) {
+		p ^= x & 1;
+	}
+
+	return p;
+}
+
+conv_trellis::conv_trellis(const std::vector<int> &generators, int feedback)
+	: d_nu(0), d_generators(generators), d_feedback(feedback)
+{
+	int n_out = generators.size() + ((feedback != 0) ? 1 : 0);
+
+	if (generators.empty()) {
+		throw std::runtime_error("At least one generator is required.");
+	}
+
+	if (n_out > 16) {
+		throw std::runtime_error("Too many generators.");
+	}
+
+	//The memory of the code is given by the highest polynomial degree
+	for(size_t j=0 ; j <= generators.size() ; ++j) {
+		int poly = (j < generators.size()) ? generators[j] : feedback;
+		int nu = -1;
+
+		if (poly < 0) {
+			throw std::runtime_error("Invalid polynomial.");
+		}
+
+		for( ; poly != 0 ; poly >>= 1) {
+			++nu;
+		}
+		d_nu = std::max(d_nu, nu);
+	}
+
+	if ((d_nu < 1) || (d_nu > 16)) {
+		throw std::runtime_error("Invalid memory for the code.");
+	}
+
+	//A recursive code needs the current input in its feedback loop
+	if ((feedback != 0) && !((feedback >> d_nu) & 1)) {
+		throw std::runtime_error("Invalid feedback polynomial.");
+	}
+
+	d_S = 1 << d_nu;
+	d_O = 1 << n_out;
+	d_NS.resize(2*d_S);
+	d_OS.resize(2*d_S);
+
+	for(int s=0 ; s < d_S ; ++s) {
+		for(int i=0 ; i < 2 ; ++i) {
+			int a = i ^ ((feedback != 0) ? conv_parity(s & feedback) : 0);
+			int reg = (a << d_nu) | s;
+			int o = (feedback != 0) ? i : 0;
+
+			for(size_t j=0 ; j < generators.size() ; ++j) {
+				o = (o << 1) | conv_parity(reg & generators[j]);
+			}
+
+			d_NS[s*2+i] = reg >> 1;
+			d_OS[s*2+i] = o;
+		}
+	}
+}
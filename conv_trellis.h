@@ -0,0 +1,97 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_CONV_TRELLIS_H
+#define INCLUDED_TURBO_CONV_TRELLIS_H
+
+#include <vector>
+#include <stdexcept>
+
+/*!
+* \brief Trellis of a binary convolutional code, built from its generator
+* (and feedback) polynomials.
+*
+* Polynomials are given as integers (usually written in octal), whose most
+* significant bit is the coefficient of the current input (D^0), and least
+* significant bit the coefficient of the oldest one (D^nu), nu being the
+* memory of the code. For instance, the K=7 code of generators (171,133).
+*
+* State s holds the nu last register inputs, the most recent one in the most
+* significant bit. With a register input a, the register is reg = a*2^nu + s,
+* and the next state is reg/2.
+*
+* - Without feedback (feedback = 0), the code is feedforward: a is the input
+*   bit, and output bit j is the parity of reg & generators[j].
+* - With feedback, the code is recursive systematic: a is the input bit
+*   xored with the parity of s & feedback, the first output bit is the input
+*   bit, and the next ones are the parities of reg & generators[j].
+*
+* The first output bit is the most significant bit of the output symbol, as
+* expected by puncturing_pattern. NS and OS can be given to viterbi,
+* log_bcjr, max_log_bcjr or prob_bcjr.
+*/
+class conv_trellis
+{
+	private:
+		//! The memory of the code (number of delay elements).
+		int d_nu;
+		//! The number of states in the trellis.
+		int d_S;
+		//! The number of possible outputs.
+		int d_O;
+		//! Generator polynomials.
+		std::vector<int> d_generators;
+		//! Feedback polynomial (0 for feedforward codes).
+		int d_feedback;
+
+		//! Next state: NS[s*2+i]=ns.
+		std::vector<int> d_NS;
+		//! Output symbol: OS[s*2+i]=os.
+		std::vector<int> d_OS;
+
+	public:
+		/*! Constructs a conv_trellis object.
+		 *
+		 * \param generators Generator polynomials (one per output bit of a
+		 *  feedforward code, one per parity bit of a recursive systematic
+		 *  code).
+		 * \param feedback Feedback polynomial, or 0 for a feedforward code.
+		 */
+		conv_trellis(const std::vector<int> &generators, int feedback = 0);
+
+		//! Getter for the number of inputs (always 2).
+		int get_I() { return 2; }
+		//! Getter for d_S.
+		int get_S() { return d_S; }
+		//! Getter for d_O.
+		int get_O() { return d_O; }
+		//! Getter for d_nu.
+		int get_nu() { return d_nu; }
+		//! Getter for d_generators.
+		std::vector<int>& get_generators() { return d_generators; }
+		//! Getter for d_feedback.
+		int get_feedback() { return d_feedback; }
+		//! Getter for d_NS.
+		std::vector<int>& get_NS() { return d_NS; }
+		//! Getter for d_OS.
+		std::vector<int>& get_OS() { return d_OS; }
+};
+
+#endif /* INCLUDED_TURBO_CONV_TRELLIS_H */
@@ -0,0 +1,100 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "crc.h"
+
+crc::crc(int width, uint64_t poly, uint64_t init, uint64_t xorout)
+	: d_width(width), d_table(256)
+{
+	if ((width < 1) || (width > 64)) {
+		throw std::runtime_error("Invalid CRC width.");
+	}
+
+	d_mask = (width == 64) ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1);
+	d_poly = poly & d_mask;
+	d_init = init & d_mask;
+	d_xorout = xorout & d_mask;
+
+	//Register update after shifting in 8 bits, indexed by the 8 bits xored
+	//with the 8 most significant bits of the register
+	for(int b=0 ; b < 256 ; ++b) {
+		uint64_t reg = 0;
+
+		for(int j=7 ; j >= 0 ; --j) {
+			bool msb = ((reg >> (width-1)) & 1) ^ ((b >> j) & 1);
+
+			reg = (reg << 1) & d_mask;
+			if (msb) {
+				reg ^= d_poly;
+			}
+		}
+
+		d_table[b] = reg;
+	}
+}
+
+uint64_t
+crc::compute(const unsigned int *bits, size_t n_bits) const
+{
+	uint64_t reg = d_init;
+	size_t n = 0;
+
+	//Whole bytes, through the table
+	if (d_width >= 8) {
+		for( ; n + 8 <= n_bits ; n += 8) {
+			unsigned int byte = 0;
+
+			for(int j=0 ; j < 8 ; ++j) {
+				byte = (byte << 1) | (bits[n+j] & 1);
+			}
+
+			byte ^= (reg >> (d_width-8)) & 0xFF;
+			reg = ((reg << 8) & d_mask) ^ d_table[byte];
+		}
+	}
+
+	//Remaining bits
+	for( ; n < n_bits ; ++n) {
+		bool msb = ((reg >> (d_width-1)) & 1) ^ (bits[n] & 1);
+
+		reg = (reg << 1) & d_mask;
+		if (msb) {
+			reg ^= d_poly;
+		}
+	}
+
+	return reg ^ d_xorout;
+}
+
+bool
+crc::check(const unsigned int *bits, size_t n_bits) const
+{
+	uint64_t expected = 0;
+
+	if (n_bits < (size_t)d_width) {
+		return false;
+	}
+
+	for(size_t n=n_bits-d_width ; n < n_bits ; ++n) {
+		expected = (expected << 1) | (bits[n] & 1);
+	}
+
+	return compute(bits, n_bits - d_width) == expected;
+}
@@ -0,0 +1,85 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_CRC_H
+#define INCLUDED_TURBO_CRC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+/*!
+* \brief Cyclic redundancy check over a sequence of bits.
+*
+* Bits are processed in order (most significant bit of the CRC first), one
+* unsigned int per bit as produced by viterbi::viterbi_algorithm(), without
+* reflection. For instance, the CRC24A of LTE is crc(24, 0x864CFB).
+*/
+class crc
+{
+	private:
+		//! Number of bits of the CRC.
+		int d_width;
+		//! Generator polynomial (without the x^width term).
+		uint64_t d_poly;
+		//! Initial value of the register.
+		uint64_t d_init;
+		//! Value xored with the register to obtain the CRC.
+		uint64_t d_xorout;
+		//! Mask of the d_width least significant bits.
+		uint64_t d_mask;
+		//! Register update for every byte value, see compute().
+		std::vector<uint64_t> d_table;
+
+	public:
+		/*! Constructs a crc object.
+		 *
+		 * \param width Number of bits of the CRC (1 to 64).
+		 * \param poly Generator polynomial, without the x^width term.
+		 * \param init Initial value of the register.
+		 * \param xorout Value xored with the register to obtain the CRC.
+		 */
+		crc(int width, uint64_t poly, uint64_t init = 0, uint64_t xorout = 0);
+
+		/*! Computes the CRC of a sequence of bits.
+		 *
+		 * \param bits Bits (0 or 1) of the sequence (size: n_bits).
+		 * \param n_bits Number of bits.
+		 *
+		 * \return The CRC.
+		 */
+		uint64_t compute(const unsigned int *bits, size_t n_bits) const;
+
+		/*! Checks a sequence of bits followed by its CRC.
+		 *
+		 * \param bits Bits of the sequence, then d_width CRC bits, most
+		 *  significant first (size: n_bits).
+		 * \param n_bits Number of bits, including the CRC.
+		 *
+		 * \return true if the CRC matches.
+		 */
+		bool check(const unsigned int *bits, size_t n_bits) const;
+
+		//! Getter for d_width.
+		int get_width() const { return d_width; }
+};
+
+#endif /* INCLUDED_TURBO_CRC_H */
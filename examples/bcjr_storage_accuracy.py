@@ -0,0 +1,86 @@
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+from PyTurbo import PyProbBCJR as prob_bcjr
+from PyTurbo import PyConvTrellis as conv_trellis
+
+from cc_common import encode, log_bcjr_branch_metrics, compute_llr
+
+import numpy
+import time
+
+#Accuracy and throughput of the BCJR decoders when forward metrics are
+#stored in a 16-bit format (float16, bfloat16 or int16) instead of float32,
+#on the K=7 (171,133) convolutive code.
+
+#Return the median decoding time of a block (in seconds)
+def measure_time(dec, A0, BK, bm, n_runs):
+    t = numpy.zeros(n_runs)
+
+    for n in range(0, n_runs):
+        t0 = time.perf_counter()
+        dec.log_bcjr_algorithm(A0, BK, bm)
+        t[n] = time.perf_counter() - t0
+
+    return numpy.median(t)
+
+trellis = conv_trellis([0o171, 0o133])
+I = trellis.get_I()
+S = trellis.get_S()
+O = trellis.get_O()
+NS = trellis.get_NS()
+OS = trellis.get_OS()
+A0 = numpy.log([1.0/S]*S, dtype=numpy.float32)
+BK = numpy.log([1.0/S]*S, dtype=numpy.float32)
+
+#Linear metrics (prob_bcjr) need the exponent range of float32 or bfloat16
+decoders = [('log_bcjr', bcjr(I, S, O, NS, OS),
+            ['float16', 'bfloat16', 'int16']),
+        ('max_log_bcjr', max_log_bcjr(I, S, O, NS, OS),
+            ['float16', 'bfloat16', 'int16']),
+        ('prob_bcjr', prob_bcjr(I, S, O, NS, OS), ['bfloat16'])]
+
+print('Accuracy (K=20000), compared with float32 storage:')
+K = 20000
+for EbN0dB in [0, 2, 4]:
+    sigma_b2 = 0.5*numpy.power(10, -EbN0dB/10)
+
+    m = numpy.random.randint(0, 2, K)
+    r = encode(trellis, m) + numpy.random.normal(0.0, numpy.sqrt(sigma_b2/2), 2*K)
+    bm = log_bcjr_branch_metrics(r, sigma_b2)
+
+    for name, dec, storages in decoders:
+        dec.set_storage('float32')
+        llr_ref = compute_llr(dec.log_bcjr_algorithm(A0, BK, bm), K, S)
+        n_err_ref = numpy.sum((llr_ref<0) != m)
+
+        for storage in storages:
+            dec.set_storage(storage)
+            llr = compute_llr(dec.log_bcjr_algorithm(A0, BK, bm), K, S)
+
+            #Only reliable LLRs are compared, very large ones may saturate
+            reliable = numpy.abs(llr_ref) < 80
+            max_err = numpy.max(numpy.abs(llr-llr_ref)[reliable])
+            n_err = numpy.sum((llr<0) != m)
+
+            print('Eb/N0 = ' + str(EbN0dB) + 'dB, ' + name + ', ' + storage
+                    + ': max LLR error ' + str(max_err) + ', bit errors '
+                    + str(n_err) + ' (float32: ' + str(n_err_ref) + ')')
+
+#Decoders return their APPs with a single copy, so that timings are dominated
+#by the recursions (and the memory traffic of stored forward metrics)
+print('Throughput:')
+for K in [1024, 16384, 65536]:
+    bm = numpy.random.normal(0.0, 1.0, K*O).astype(numpy.float32)
+    n_runs = max(3, int(50000/K))
+
+    for name, dec, storages in decoders:
+        dec.set_storage('float32')
+        t_ref = measure_time(dec, A0, BK, bm, n_runs)
+        line = name + ' K=' + str(K) + ': float32 ' + str(K/t_ref/1e6) + ' Mbit/s'
+
+        for storage in storages:
+            dec.set_storage(storage)
+            t = measure_time(dec, A0, BK, bm, n_runs)
+            line += ', ' + storage + ' ' + str(K/t/1e6) + ' Mbit/s'
+
+        print(line)
@@ -0,0 +1,66 @@
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+
+import numpy
+import time
+
+#Latency of a single block decoding with the serial and the bidirectional
+#(forward and backward recursions on two threads) schedules.
+#The bidirectional schedule only reduces latency with at least two cores.
+
+#Build the trellis of the K=7 (171,133) convolutive code
+def k7_trellis():
+    I = 2
+    S = 64
+    O = 4
+    NS = [0]*(S*I)
+    OS = [0]*(S*I)
+
+    for s in range(0, S):
+        for i in range(0, I):
+            reg = (i << 6) | s
+            NS[s*I+i] = reg >> 1
+            OS[s*I+i] = 2*(bin(reg & 0o171).count('1') % 2) \
+                    + (bin(reg & 0o133).count('1') % 2)
+
+    return I, S, O, NS, OS
+
+#Return the median decoding time of a block (in seconds)
+def measure_latency(dec, A0, BK, bm, n_runs):
+    latency = numpy.zeros(n_runs)
+
+    for n in range(0, n_runs):
+        t0 = time.perf_counter()
+        dec.log_bcjr_algorithm(A0, BK, bm)
+        latency[n] = time.perf_counter() - t0
+
+    return numpy.median(latency)
+
+I, S, O, NS, OS = k7_trellis()
+A0 = numpy.log([1.0/S]*S, dtype=numpy.float32)
+BK = numpy.log([1.0/S]*S, dtype=numpy.float32)
+
+decoders = [('log_bcjr', bcjr(I, S, O, NS, OS)),
+        ('max_log_bcjr', max_log_bcjr(I, S, O, NS, OS))]
+
+for K in [256, 1024, 8192, 65536]:
+    bm = numpy.random.normal(0.0, 1.0, K*O).astype(numpy.float32)
+    n_runs = max(3, int(200000/K))
+
+    for name, dec in decoders:
+        dec.set_bidirectional(False)
+        t_serial = measure_latency(dec, A0, BK, bm, n_runs)
+
+        dec.set_bidirectional(True)
+        t_bidir = measure_latency(dec, A0, BK, bm, n_runs)
+
+        #Both schedules must yield the same APPs
+        dec.set_bidirectional(False)
+        app_serial = dec.log_bcjr_algorithm(A0, BK, bm)
+        dec.set_bidirectional(True)
+        app_bidir = dec.log_bcjr_algorithm(A0, BK, bm)
+        assert numpy.array_equal(app_serial, app_bidir)
+
+        print(name + ' K=' + str(K) + ': serial ' + str(1e3*t_serial) + ' ms, '
+                + 'bidirectional ' + str(1e3*t_bidir) + ' ms (speedup: '
+                + str(t_serial/t_bidir) + ')')
@@ -0,0 +1,39 @@
+import numpy
+import scipy.special
+
+#Helpers shared by the convolutive code examples, for trellises built with
+#PyConvTrellis (the first generator yields the most significant bit of a
+#branch output).
+
+#Encode a message, starting from the all-0 state, by walking the trellis
+def encode(trellis, msg):
+    I = trellis.get_I()
+    NS = trellis.get_NS()
+    OS = trellis.get_OS()
+    n_out = trellis.get_O().bit_length() - 1
+    out_msg = numpy.zeros(n_out*len(msg), dtype=bool)
+
+    s = 0
+    for k in range(0, len(msg)):
+        o = OS[s*I + int(msg[k])]
+        s = NS[s*I + int(msg[k])]
+        for i in range(0, n_out):
+            out_msg[k*n_out+i] = (o >> (n_out-1-i)) & 1
+
+    return out_msg
+
+#Compute log-BCJR branch metrics for a sequence of received bits
+def log_bcjr_branch_metrics(bits_rcvd, sigma_b2, n_out=2):
+    #Coded bits of every branch output (first output is the MSB)
+    cw = (numpy.arange(2**n_out)[:,None] >> numpy.arange(n_out-1, -1, -1)) & 1
+
+    bits_rcvd = numpy.asarray(bits_rcvd).reshape((-1, n_out))
+    ret_val = -1.0/sigma_b2 * numpy.sum(numpy.abs(bits_rcvd[:,None,:]-cw[None,:,:])**2, axis=2)
+
+    return ret_val.astype(numpy.float32).flatten()
+
+#Compute bit LLR from a posteriori-probabilities
+def compute_llr(app, K, S):
+    app = app.reshape((K, S, 2))
+    return scipy.special.logsumexp(app[:,:,0], axis=1) \
+        - scipy.special.logsumexp(app[:,:,1], axis=1)
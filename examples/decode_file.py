@@ -0,0 +1,66 @@
+from PyTurbo import PyViterbi as viterbi
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+from PyTurbo import PyProbBCJR as prob_bcjr
+from PyTurbo import PyFileDecoder as file_decoder
+from PyTurbo import PyConvTrellis as conv_trellis
+
+import argparse
+import numpy
+import time
+
+#Decodes a raw float32 branch metric file, block by block, with a
+#feedforward convolutive code.
+#
+#Input file contains O float32 per time index: log of branch metrics for BCJR
+#decoders, distances (to be minimized) for the Viterbi decoder.
+#Output file contains LLRs (float32, or branch APPs with --app) for BCJR
+#decoders, and decoded bits (uint16) for the Viterbi decoder.
+#
+#Example (K=7 (171,133) code):
+#python3 decode_file.py -g 171 133 -d max_log_bcjr metrics.bin llr.bin
+
+decoders = {'viterbi': viterbi, 'log_bcjr': bcjr,
+        'max_log_bcjr': max_log_bcjr, 'prob_bcjr': prob_bcjr}
+
+parser = argparse.ArgumentParser(description='Decode a raw float32 branch metric file.')
+parser.add_argument('in_path', help='input branch metric file')
+parser.add_argument('out_path', help='output file (overwritten)')
+parser.add_argument('-g', '--generators', nargs='+', default=['7', '5'],
+        help='generators of the code, in octal (default: 7 5)')
+parser.add_argument('-d', '--decoder', choices=sorted(decoders.keys()),
+        default='log_bcjr', help='decoding algorithm (default: log_bcjr)')
+parser.add_argument('-k', '--block-len', type=int, default=65536,
+        help='time indexes per block (default: 65536)')
+parser.add_argument('-q', '--queue-depth', type=int, default=4,
+        help='blocks waiting between two pipeline stages (default: 4)')
+parser.add_argument('-z', '--zero-start', action='store_true',
+        help='each block starts in the all-0 state')
+parser.add_argument('--app', action='store_true',
+        help='write branch APPs instead of LLRs (BCJR decoders only)')
+args = parser.parse_args()
+
+#The first generator yields the most significant bit of a branch output
+trellis = conv_trellis([int(g, 8) for g in args.generators])
+S = trellis.get_S()
+dec = decoders[args.decoder](trellis.get_I(), S, trellis.get_O(),
+        trellis.get_NS(), trellis.get_OS())
+pipeline = file_decoder(args.block_len, args.queue_depth)
+
+t0 = time.perf_counter()
+if args.decoder == 'viterbi':
+    K = pipeline.decode_viterbi(dec, 0 if args.zero_start else -1, -1,
+            args.in_path, args.out_path)
+else:
+    if args.zero_start:
+        A0 = numpy.log([1.0] + [1e-20]*(S-1), dtype=numpy.float32)
+    else:
+        A0 = numpy.log([1.0/S]*S, dtype=numpy.float32)
+    BK = numpy.log([1.0/S]*S, dtype=numpy.float32) #Do not know in which state we end
+
+    K = pipeline.decode_bcjr(dec, A0, BK, args.in_path, args.out_path,
+            not args.app)
+elapsed = time.perf_counter() - t0
+
+print('Decoded ' + str(K) + ' time indexes in ' + str(elapsed) + ' s ('
+        + str(K/elapsed/1e6) + ' Msteps/s)')
@@ -0,0 +1,70 @@
+from PyTurbo import PyViterbi as viterbi
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+from PyTurbo import PyFixedViterbi as fixed_viterbi
+from PyTurbo import PyFixedBCJR as fixed_bcjr
+from PyTurbo import PyConvTrellis as conv_trellis
+from PyTurbo import fixed_code_names
+
+import numpy
+import time
+
+#Throughput of the decoders specialized at compile time for standard codes,
+#compared with the generic decoders built from the same trellis.
+#Every decoder returns its results with a single copy, so that timings compare
+#the decoders themselves.
+
+#Polynomials of the codes with specialized decoders: (generators, feedback)
+codes = {'cc_7_5': ([0o5, 0o7], 0),
+        'cc_171_133': ([0o171, 0o133], 0),
+        'lte_cc': ([0o133, 0o171, 0o165], 0),
+        'lte_rsc': ([0o15], 0o13)}
+
+#Return the median decoding time of a block (in seconds)
+def measure_time(decode, n_runs):
+    t = numpy.zeros(n_runs)
+
+    for n in range(0, n_runs):
+        t0 = time.perf_counter()
+        decode()
+        t[n] = time.perf_counter() - t0
+
+    return numpy.median(t)
+
+for name in fixed_code_names():
+    generators, feedback = codes[name]
+    trellis = conv_trellis(generators, feedback)
+    I = trellis.get_I()
+    S = trellis.get_S()
+    O = trellis.get_O()
+    NS = trellis.get_NS()
+    OS = trellis.get_OS()
+
+    A0 = numpy.log([1.0/S]*S, dtype=numpy.float32)
+    BK = numpy.log([1.0/S]*S, dtype=numpy.float32)
+
+    K = 20000
+    bm = numpy.random.normal(0.0, 1.0, K*O).astype(numpy.float32)
+
+    #Viterbi
+    dec = viterbi(I, S, O, NS, OS)
+    dec_fixed = fixed_viterbi(name)
+    assert numpy.array_equal(dec.viterbi_algorithm(-1, -1, bm),
+            dec_fixed.viterbi_algorithm(-1, -1, bm))
+
+    t = measure_time(lambda: dec.viterbi_algorithm(-1, -1, bm), 10)
+    t_fixed = measure_time(lambda: dec_fixed.viterbi_algorithm(-1, -1, bm), 10)
+    print(name + ' viterbi: generic ' + str(K/t/1e6) + ' Mbit/s, fixed '
+            + str(K/t_fixed/1e6) + ' Mbit/s')
+
+    #BCJR
+    for dec_name, dec, dec_fixed in [
+            ('log_bcjr', bcjr(I, S, O, NS, OS), fixed_bcjr(name)),
+            ('max_log_bcjr', max_log_bcjr(I, S, O, NS, OS), fixed_bcjr(name, True))]:
+        assert numpy.array_equal(dec.log_bcjr_algorithm(A0, BK, bm),
+                dec_fixed.log_bcjr_algorithm(A0, BK, bm))
+
+        t = measure_time(lambda: dec.log_bcjr_algorithm(A0, BK, bm), 3)
+        t_fixed = measure_time(lambda: dec_fixed.log_bcjr_algorithm(A0, BK, bm), 3)
+        print(name + ' ' + dec_name + ': generic ' + str(K/t/1e6)
+                + ' Mbit/s, fixed ' + str(K/t_fixed/1e6) + ' Mbit/s')
@@ -0,0 +1,40 @@
+from PyTurbo import PyISITrellis as isi_trellis
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+
+import numpy
+
+#BCJR equalization of BPSK symbols over a memory-4 ISI channel (16 states).
+
+#Channel taps and constellation
+h = numpy.array([0.227, 0.460, 0.688, 0.460, 0.227])
+constellation = numpy.array([1.0, -1.0])
+
+#Build the trellis of the channel
+trellis = isi_trellis(h, constellation)
+I = trellis.get_I()
+S = trellis.get_S()
+O = trellis.get_O()
+
+dec = max_log_bcjr(I, S, O, trellis.get_NS(), trellis.get_OS())
+
+K = 100000
+A0 = numpy.log([1.0] + [1e-20]*(S-1), dtype=numpy.float32) #Channel memory is filled with symbol 0
+BK = numpy.log([1.0/S]*S, dtype=numpy.float32) #Do not know in which state we end
+
+for EbN0dB in range(0, 12, 2):
+    sigma_b2 = numpy.power(10, -EbN0dB/10)
+
+    #Transmit symbols (the channel memory initially holds symbol 0)
+    m = numpy.random.randint(0, 2, K)
+    x = numpy.concatenate((constellation[[0]*(len(h)-1)], constellation[m]))
+    noise = numpy.random.normal(0.0, numpy.sqrt(sigma_b2/2), K) \
+            + 1j*numpy.random.normal(0.0, numpy.sqrt(sigma_b2/2), K)
+    r = numpy.convolve(x, h, mode='valid') + noise
+
+    #Equalize, without a-priori information (first turbo iteration)
+    bm = trellis.branch_metrics(r, sigma_b2)
+    app = dec.log_bcjr_algorithm(A0, BK, bm).reshape((K, S, I))
+    llr = numpy.max(app[:,:,0], axis=1) - numpy.max(app[:,:,1], axis=1)
+
+    print('BER for max_log_bcjr equalizer at Eb/N0 = ' + str(EbN0dB) + 'dB: '
+            + str(numpy.mean(m != (llr < 0))))
@@ -0,0 +1,70 @@
+from PyTurbo import PyFixedViterbi as fixed_viterbi
+from PyTurbo import PyConvTrellis as conv_trellis
+from PyTurbo import PyCRC as crc
+
+import numpy
+import time
+
+#Frame error rate of the K=7 (171,133) convolutive code with a CRC16, decoded
+#with the Viterbi algorithm (the frame is lost if the CRC fails), and with the
+#CRC-aided list Viterbi algorithm (the first of the L best candidates passing
+#the CRC is kept).
+
+#Return the branch metrics (squared distances) of BPSK symbols y
+def branch_metrics(y, n_out):
+    #BPSK symbols of every branch output (first output is the MSB)
+    out_bits = (numpy.arange(2**n_out)[:,None] >> numpy.arange(n_out-1, -1, -1)) & 1
+    x = 1.0 - 2.0*out_bits
+
+    y = y.reshape(-1, n_out)
+    return ((y[:,None,:] - x[None,:,:])**2).sum(axis=2).astype(numpy.float32).flatten()
+
+trellis = conv_trellis([0o171, 0o133])
+NS = trellis.get_NS()
+OS = trellis.get_OS()
+nu = trellis.get_nu()
+n_out = 2
+dec = fixed_viterbi('cc_171_133')
+crc16 = crc(16, 0x1021)
+
+n_data = 64
+n_checked = n_data + crc16.get_width()
+K = n_checked + nu #Tail bits bring the encoder back to state 0
+L_list = [1, 4, 16]
+n_frames = 2000
+
+for EbN0_dB in [1.0, 2.0, 3.0]:
+    #Noise variance per BPSK symbol (rate n_data/(n_out*K))
+    EbN0 = 10**(EbN0_dB/10.0)
+    sigma = numpy.sqrt(n_out*K/(2.0*n_data*EbN0))
+
+    n_errors = dict((L, 0) for L in L_list)
+    elapsed = dict((L, 0.0) for L in L_list)
+
+    for n in range(0, n_frames):
+        data = numpy.random.randint(0, 2, n_data)
+        bits = numpy.concatenate((crc16.append(data), numpy.zeros(nu, dtype=numpy.uint16)))
+
+        #Encoding
+        s = 0
+        coded = numpy.zeros(K*n_out)
+        for k in range(0, K):
+            o = OS[s*2 + bits[k]]
+            s = NS[s*2 + bits[k]]
+            coded[k*n_out:(k+1)*n_out] = [(o >> (n_out-1-i)) & 1 for i in range(0, n_out)]
+
+        y = (1.0 - 2.0*coded) + numpy.random.normal(0.0, sigma, K*n_out)
+        bm = branch_metrics(y, n_out)
+
+        for L in L_list:
+            t0 = time.perf_counter()
+            decoded, rank = dec.viterbi_algorithm_list_crc(0, 0, bm, L, crc16, n_checked)
+            elapsed[L] += time.perf_counter() - t0
+
+            if rank < 0 or not numpy.array_equal(decoded[0:n_data], data):
+                n_errors[L] += 1
+
+    print('Eb/N0 = ' + str(EbN0_dB) + ' dB')
+    for L in L_list:
+        print('  L = ' + str(L) + ': FER ' + str(n_errors[L]/float(n_frames))
+                + ', ' + str(elapsed[L]/n_frames*1e6) + ' us/frame')
@@ -0,0 +1,53 @@
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyProbBCJR as prob_bcjr
+from PyTurbo import PyConvTrellis as conv_trellis
+
+from cc_common import encode, log_bcjr_branch_metrics, compute_llr
+
+import numpy
+import time
+
+#Numerical accuracy and throughput of the probability-domain BCJR, compared
+#with the log-domain BCJR, on the K=7 (171,133) convolutive code.
+
+trellis = conv_trellis([0o171, 0o133])
+I = trellis.get_I()
+S = trellis.get_S()
+O = trellis.get_O()
+NS = trellis.get_NS()
+OS = trellis.get_OS()
+dec_log_bcjr = bcjr(I, S, O, NS, OS)
+dec_prob_bcjr = prob_bcjr(I, S, O, NS, OS)
+
+K = 20000
+A0 = numpy.log([1.0/S]*S, dtype=numpy.float32)
+BK = numpy.log([1.0/S]*S, dtype=numpy.float32)
+
+for EbN0dB in [0, 2, 4, 6]:
+    sigma_b2 = 0.5*numpy.power(10, -EbN0dB/10)
+
+    m = numpy.random.randint(0, 2, K)
+    r = encode(trellis, m) + numpy.random.normal(0.0, numpy.sqrt(sigma_b2/2), 2*K)
+    bm = log_bcjr_branch_metrics(r, sigma_b2)
+
+    t0 = time.perf_counter()
+    app_log = dec_log_bcjr.log_bcjr_algorithm(A0, BK, bm)
+    t_log = time.perf_counter() - t0
+
+    t0 = time.perf_counter()
+    app_prob = dec_prob_bcjr.log_bcjr_algorithm(A0, BK, bm)
+    t_prob = time.perf_counter() - t0
+
+    llr_log = compute_llr(app_log, K, S)
+    llr_prob = compute_llr(app_prob, K, S)
+
+    #LLRs with a magnitude beyond ~80 may be clipped differently by the
+    #probability-domain decoder, see prob_bcjr.h
+    reliable = numpy.abs(llr_log) < 80
+    max_err = numpy.max(numpy.abs(llr_log-llr_prob)[reliable])
+    n_diff = numpy.sum((llr_log<0) != (llr_prob<0))
+
+    print('Eb/N0 = ' + str(EbN0dB) + 'dB: max LLR error ' + str(max_err)
+            + ', differing decisions ' + str(n_diff)
+            + ', log_bcjr ' + str(K/t_log/1e6) + ' Mbit/s'
+            + ', prob_bcjr ' + str(K/t_prob/1e6) + ' Mbit/s')
@@ -0,0 +1,53 @@
+from PyTurbo import PyMaxLogBCJR as max_log_bcjr
+from PyTurbo import PyPuncturingPattern as puncturing_pattern
+from PyTurbo import PyViterbi as viterbi
+from PyTurbo import PyConvTrellis as conv_trellis
+
+from cc_common import encode
+
+import numpy
+
+#Decoding of the K=7 (171,133) convolutive code punctured to rates 2/3, 3/4
+#and 7/8. Soft inputs of the transmitted bits are given directly to the
+#decoders, which skip punctured positions.
+
+#Puncturing patterns (both coded bits of each trellis step, interleaved)
+patterns = [('1/2', [1,1]),
+        ('2/3', [1,1, 0,1]),
+        ('3/4', [1,1, 0,1, 1,0]),
+        ('7/8', [1,1, 0,1, 0,1, 0,1, 1,0, 0,1, 1,0])]
+
+trellis = conv_trellis([0o171, 0o133])
+I = trellis.get_I()
+S = trellis.get_S()
+O = trellis.get_O()
+NS = trellis.get_NS()
+OS = trellis.get_OS()
+dec_vit = viterbi(I, S, O, NS, OS)
+dec_max_log_bcjr = max_log_bcjr(I, S, O, NS, OS)
+
+K = 50000
+EbN0dB = 4
+A0 = numpy.log([1.0] + [1e-20]*(S-1), dtype=numpy.float32) #Trellis begin in first state (all-0)
+BK = numpy.log([1.0/S]*S, dtype=numpy.float32) #Do not know in which state we end
+
+for rate_name, pattern in patterns:
+    punct = puncturing_pattern(2, pattern)
+    R = K/punct.get_n_soft(K)
+    sigma_b2 = 1/(2*R)*numpy.power(10, -EbN0dB/10)
+
+    #Encode, puncture and transmit BPSK symbols
+    m = numpy.random.randint(0, 2, K)
+    x = 1.0 - 2.0*punct.puncture(encode(trellis, m))
+    r = x + numpy.random.normal(0.0, numpy.sqrt(sigma_b2), len(x))
+    llr = (2.0/sigma_b2*r).astype(numpy.float32)
+
+    m_hat_vit = dec_vit.viterbi_algorithm_punctured(0, -1, llr, punct, K)
+
+    app = dec_max_log_bcjr.log_bcjr_algorithm_punctured(A0, BK, llr, punct, K)
+    app = app.reshape((K, S, 2))
+    m_hat_bcjr = numpy.max(app[:,:,0], axis=1) < numpy.max(app[:,:,1], axis=1)
+
+    print('Rate ' + rate_name + ' at Eb/N0 = ' + str(EbN0dB) + 'dB: BER '
+            + str(numpy.mean(m != m_hat_vit)) + ' (viterbi), '
+            + str(numpy.mean(m != m_hat_bcjr)) + ' (max_log_bcjr)')
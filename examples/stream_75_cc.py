@@ -0,0 +1,78 @@
+from PyTurbo import PyLogBCJR as bcjr
+from PyTurbo import PyBCJRStream as bcjr_stream
+
+import numpy
+
+#Decoding of a continuous stream of (7,5) convolutive coded bits, received by
+#chunks of random sizes, with a fixed latency.
+
+#Quick implementation of a (7,5) convolutive code encoder
+def encode75(msg, reg):
+    out_msg = numpy.zeros(2*len(msg), dtype=bool)
+
+    for i in range(0, len(msg)):
+        #Compute outputs
+        out_msg[2*i] = msg[i]^reg[1]
+        out_msg[2*i+1] = msg[i]^reg[0]^reg[1]
+
+        #Update shift register
+        reg[1] = reg[0]
+        reg[0] = msg[i]
+
+    return out_msg
+
+#Compute log-BCJR branch metrics for a sequence of received bits
+def log_bcjr_branch_metrics(bits_rcvd, sigma_b2):
+    K = int(len(bits_rcvd)/2)
+    ret_val = numpy.zeros((K, 4), dtype=numpy.float32);
+    cw = numpy.array([[0.0,0.0], [0.0,1.0], [1.0,0.0], [1.0,1.0]]) #The 4 different codewords
+
+    bits_rcvd = numpy.array(bits_rcvd).reshape((K, 2))
+    for i in range(0, 4):
+        ret_val[:,i] = -1.0/sigma_b2 * numpy.sum(numpy.abs(bits_rcvd-cw[i])**2, axis=1)
+
+    return ret_val.flatten()
+
+#Define trellis
+I=2
+S=4
+O=4
+NS = [0, 2, \
+      0, 2, \
+      1, 3, \
+      1, 3]
+OS = [0, 3, \
+      3, 0, \
+      1, 2, \
+      2, 1]
+
+EbN0dB = 3
+sigma_b2 = 0.5*numpy.power(10, -EbN0dB/10)
+
+A0 = numpy.log([1.0, 1e-20, 1e-20, 1e-20], dtype=numpy.float32) #Trellis begin in first state (all-0)
+BK = numpy.log([1.0/4]*4, dtype=numpy.float32) #Do not know in which state we end
+
+#APPs of a bit are emitted 30 bits after it was received
+dec = bcjr(I, S, O, NS, OS)
+stream = bcjr_stream(dec, A0, 30, True)
+
+reg = [0,0]
+m = []
+llr = []
+for n in range(0, 200):
+    #Receive a chunk of random size
+    K_chunk = numpy.random.randint(1, 2000)
+    m_chunk = numpy.random.randint(0, 2, K_chunk)
+    r = encode75(m_chunk, reg) + numpy.random.normal(0.0, numpy.sqrt(sigma_b2/2), 2*K_chunk)
+
+    m.append(m_chunk)
+    llr.append(stream.push(log_bcjr_branch_metrics(r, sigma_b2)))
+
+#End of stream
+llr.append(stream.flush(BK, A0))
+
+m = numpy.concatenate(m)
+m_hat = numpy.concatenate(llr) < 0
+
+print('BER For streamed log_bcjr at Eb/N0 = ' + str(EbN0dB) + 'dB: '
+        + str(numpy.mean(m != m_hat)) + ' (' + str(len(m)) + ' bits)')
@@ -0,0 +1,45 @@
+from PyTurbo import PyViterbi as viterbi
+from PyTurbo import PyConvTrellis as conv_trellis
+
+import numpy
+import time
+
+#Throughput of the Viterbi decoder with the vectorized ACS engine and with
+#the generic implementation, on the 64-state K=7 (171,133) convolutive code.
+
+#Return the best decoding throughput (in decoded bits per second)
+def measure_throughput(dec, bm, K, n_runs):
+    best = float('inf')
+
+    for n in range(0, n_runs):
+        t0 = time.perf_counter()
+        dec.viterbi_algorithm(-1, -1, bm)
+        best = min(best, time.perf_counter() - t0)
+
+    return K/best
+
+trellis = conv_trellis([0o171, 0o133])
+I = trellis.get_I()
+S = trellis.get_S()
+O = trellis.get_O()
+NS = trellis.get_NS()
+OS = trellis.get_OS()
+dec = viterbi(I, S, O, NS, OS)
+
+K = 200000
+bm = numpy.random.normal(0.0, 1.0, K*O).astype(numpy.float32)
+
+dec.set_vectorized(False)
+out_generic = dec.viterbi_algorithm(-1, -1, bm)
+thr_generic = measure_throughput(dec, bm, K, 5)
+
+dec.set_vectorized(True)
+out_vectorized = dec.viterbi_algorithm(-1, -1, bm)
+thr_vectorized = measure_throughput(dec, bm, K, 5)
+
+#Both implementations must take the same decisions
+assert numpy.array_equal(out_generic, out_vectorized)
+
+print('Generic ACS: ' + str(thr_generic/1e6) + ' Mbit/s')
+print('Vectorized ACS: ' + str(thr_vectorized/1e6) + ' Mbit/s (speedup: '
+        + str(thr_vectorized/thr_generic) + ')')
@@ -0,0 +1,339 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "file_decoder.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! A block of data travelling through the pipeline.
+template<class T>
+struct file_block
+{
+	//! Number of time indexes in the block.
+	size_t K;
+	std::vector<T> data;
+};
+
+/*!
+* \brief Queue of bounded size between two stages of the pipeline.
+*
+* push() blocks while the queue is full, pop() blocks while it is empty.
+* Once closed, push() drops its argument and returns false, and pop() returns
+* false as soon as the queue is empty, so that every stage ends when one of
+* them fails.
+*/
+template<class T>
+class block_queue
+{
+	private:
+		std::deque<T> d_queue;
+		size_t d_depth;
+		bool d_closed;
+		std::mutex d_mutex;
+		std::condition_variable d_not_empty;
+		std::condition_variable d_not_full;
+
+	public:
+		block_queue(size_t depth) : d_depth(depth), d_closed(false) {}
+
+		bool push(T &&item)
+		{
+			std::unique_lock<std::mutex> lock(d_mutex);
+			d_not_full.wait(lock,
+					[this]{ return d_closed || d_queue.size() < d_depth; });
+
+			if (d_closed) {
+				return false;
+			}
+
+			d_queue.push_back(std::move(item));
+			d_not_empty.notify_one();
+
+			return true;
+		}
+
+		bool pop(T &item)
+		{
+			std::unique_lock<std::mutex> lock(d_mutex);
+			d_not_empty.wait(lock,
+					[this]{ return d_closed || !d_queue.empty(); });
+
+			if (d_queue.empty()) {
+				return false;
+			}
+
+			item = std::move(d_queue.front());
+			d_queue.pop_front();
+			d_not_full.notify_one();
+
+			return true;
+		}
+
+		void close()
+		{
+			std::lock_guard<std::mutex> lock(d_mutex);
+			d_closed = true;
+			d_not_empty.notify_all();
+			d_not_full.notify_all();
+		}
+};
+
+//! Read-only memory mapping of a whole file.
+class mapped_file
+{
+	private:
+		int d_fd;
+		void *d_addr;
+		size_t d_size;
+		//! Number of bytes already released, from the start of the mapping.
+		size_t d_released;
+
+	public:
+		mapped_file(const std::string &path) : d_fd(-1), d_addr(NULL), d_size(0),
+			d_released(0)
+		{
+			struct stat st;
+
+			d_fd = open(path.c_str(), O_RDONLY);
+			if (d_fd < 0) {
+				throw std::runtime_error("Cannot open " + path);
+			}
+
+			if (fstat(d_fd, &st) != 0) {
+				close(d_fd);
+				throw std::runtime_error("Cannot stat " + path);
+			}
+			d_size = st.st_size;
+
+			if (d_size == 0) {
+				return;
+			}
+
+			d_addr = mmap(NULL, d_size, PROT_READ, MAP_PRIVATE, d_fd, 0);
+			if (d_addr == MAP_FAILED) {
+				close(d_fd);
+				throw std::runtime_error("Cannot map " + path);
+			}
+
+			madvise(d_addr, d_size, MADV_SEQUENTIAL);
+		}
+
+		~mapped_file()
+		{
+			if (d_addr != NULL) {
+				munmap(d_addr, d_size);
+			}
+			close(d_fd);
+		}
+
+		//! Releases the pages of the first offset bytes of the mapping.
+		void release(size_t offset)
+		{
+			size_t page_size = sysconf(_SC_PAGESIZE);
+
+			offset -= offset % page_size;
+			if (offset > d_released) {
+				madvise((char *)d_addr + d_released, offset - d_released,
+						MADV_DONTNEED);
+				d_released = offset;
+			}
+		}
+
+		const float *data() { return (const float *)d_addr; }
+		size_t size() { return d_size; }
+};
+
+/*!
+* Runs the read/decode/write pipeline on in_path.
+*
+* decode(const std::vector<float> &in, size_t K, std::vector<OUT_T> &out) is
+* called on the calling thread for each block (in holding the K*O metrics
+* copied by the reader thread), out being resized by decode.
+*/
+template<class OUT_T, class DECODE>
+static size_t
+run_file_pipeline(const std::string &in_path, const std::string &out_path,
+		int O, size_t block_len, size_t queue_depth, DECODE decode)
+{
+	mapped_file in_file(in_path);
+
+	if (in_file.size() % (O*sizeof(float)) != 0) {
+		throw std::runtime_error(in_path
+				+ " does not contain a whole number of time indexes");
+	}
+	size_t n_steps = in_file.size()/(O*sizeof(float));
+
+	FILE *out_file = fopen(out_path.c_str(), "wb");
+	if (out_file == NULL) {
+		throw std::runtime_error("Cannot open " + out_path);
+	}
+
+	block_queue< file_block<float> > in_queue(queue_depth);
+	block_queue< file_block<OUT_T> > out_queue(queue_depth);
+	std::exception_ptr error;
+	std::mutex error_mutex;
+
+	//Keep the first error, and stop every stage
+	auto fail = [&]() {
+		std::lock_guard<std::mutex> lock(error_mutex);
+		if (!error) {
+			error = std::current_exception();
+		}
+		in_queue.close();
+		out_queue.close();
+	};
+
+	std::thread reader([&]() {
+		try {
+			for (size_t k = 0 ; k < n_steps ; k += block_len) {
+				file_block<float> block;
+				block.K = std::min(block_len, n_steps - k);
+				block.data.assign(in_file.data() + k*O,
+						in_file.data() + (k + block.K)*O);
+				in_file.release((k + block.K)*O*sizeof(float));
+
+				//Another stage failed: stop reading the input
+				if (!in_queue.push(std::move(block))) {
+					break;
+				}
+			}
+			in_queue.close();
+		}
+		catch (...) {
+			fail();
+		}
+	});
+
+	std::thread writer([&]() {
+		try {
+			file_block<OUT_T> block;
+
+			while (out_queue.pop(block)) {
+				if (fwrite(block.data.data(), sizeof(OUT_T), block.data.size(),
+							out_file) != block.data.size()) {
+					throw std::runtime_error("Cannot write to " + out_path);
+				}
+			}
+		}
+		catch (...) {
+			fail();
+		}
+	});
+
+	try {
+		file_block<float> in_block;
+
+		while (in_queue.pop(in_block)) {
+			file_block<OUT_T> out_block;
+			out_block.K = in_block.K;
+			decode(in_block.data, in_block.K, out_block.data);
+
+			if (!out_queue.push(std::move(out_block))) {
+				break;
+			}
+		}
+		out_queue.close();
+	}
+	catch (...) {
+		fail();
+	}
+
+	reader.join();
+	writer.join();
+
+	if (fclose(out_file) != 0 && !error) {
+		throw std::runtime_error("Cannot write to " + out_path);
+	}
+
+	if (error) {
+		std::rethrow_exception(error);
+	}
+
+	return n_steps;
+}
+
+file_decoder::file_decoder(size_t block_len, size_t queue_depth)
+	: d_block_len(block_len), d_queue_depth(queue_depth)
+{
+	if (block_len == 0) {
+		throw std::runtime_error("block_len must be strictly positive");
+	}
+
+	if (queue_depth == 0) {
+		throw std::runtime_error("queue_depth must be strictly positive");
+	}
+}
+
+size_t
+file_decoder::decode(log_bcjr_base &dec, const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::string &in_path,
+		const std::string &out_path, bool llr)
+{
+	std::vector<float> app;
+
+	if ((A0.size() != (size_t)dec.get_S()) || (BK.size() != (size_t)dec.get_S())) {
+		throw std::runtime_error("A0 and BK must be of size S");
+	}
+
+	return run_file_pipeline<float>(in_path, out_path, dec.get_O(),
+			d_block_len, d_queue_depth,
+			[&](const std::vector<float> &in, size_t /*K*/,
+					std::vector<float> &out) {
+				if (llr) {
+					dec.log_bcjr_algorithm(A0, BK, in, app);
+					dec.compute_llr(app, out);
+				}
+				else {
+					dec.log_bcjr_algorithm(A0, BK, in, out);
+				}
+			});
+}
+
+size_t
+file_decoder::decode(viterbi &dec, int S0, int SK, const std::string &in_path,
+		const std::string &out_path)
+{
+	std::vector<unsigned int> decisions;
+
+	if (dec.get_I() > 65536) {
+		throw std::runtime_error("Decoded symbols do not fit in uint16");
+	}
+
+	return run_file_pipeline<uint16_t>(in_path, out_path, dec.get_O(),
+			d_block_len, d_queue_depth,
+			[&](const std::vector<float> &in, size_t K,
+					std::vector<uint16_t> &out) {
+				decisions.resize(K);
+				dec.viterbi_algorithm(K, S0, SK, in.data(), &decisions[0]);
+				out.assign(decisions.begin(), decisions.end());
+			});
+}
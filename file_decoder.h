@@ -0,0 +1,109 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_FILE_DECODER_H
+#define INCLUDED_TURBO_FILE_DECODER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "log_bcjr_base.h"
+#include "viterbi.h"
+
+/*!
+* \brief Block decoding of raw float32 branch metric files.
+*
+* The input file is memory-mapped, and cut into blocks of block_len time
+* indexes (the last block may be shorter), each block being decoded
+* independently. Three stages run concurrently:
+* - a reader thread copies blocks out of the mapping (and releases the pages
+*   once copied),
+* - the calling thread decodes them,
+* - a writer thread appends the results to the output file.
+*
+* Stages exchange blocks through queues of at most queue_depth elements, so
+* that memory use depends on block_len and queue_depth only, and not on the
+* size of the file.
+*/
+class file_decoder
+{
+	private:
+		//! Number of time indexes per block.
+		size_t d_block_len;
+		//! Maximum number of blocks waiting between two stages.
+		size_t d_queue_depth;
+
+	public:
+		/*! Constructs a file_decoder object.
+		 *
+		 * \param block_len Number of time indexes per block.
+		 * \param queue_depth Maximum number of blocks waiting between two
+		 *  stages of the pipeline.
+		 */
+		file_decoder(size_t block_len, size_t queue_depth = 4);
+
+		/*! Decodes a file with a BCJR decoder.
+		 *
+		 * Each block is decoded with log_bcjr_base::log_bcjr_algorithm(),
+		 * output is written as raw float32.
+		 *
+		 * \param dec Decoder.
+		 * \param A0 Log of initial state probabilities of each block
+		 *  (size: S).
+		 * \param BK Log of final state probabilities of each block
+		 *  (size: S).
+		 * \param in_path Path to the input file, containing log of branch
+		 *  metrics (O float32 per time index).
+		 * \param out_path Path to the output file (overwritten).
+		 * \param llr If true, write log-likelihood ratios (I-1 per time
+		 *  index, see log_bcjr_base::compute_llr()), otherwise write branch
+		 *  APPs (S*I per time index).
+		 *
+		 * \return Number of decoded time indexes.
+		 */
+		size_t decode(log_bcjr_base &dec, const std::vector<float> &A0,
+				const std::vector<float> &BK, const std::string &in_path,
+				const std::string &out_path, bool llr = true);
+
+		/*! Decodes a file with a Viterbi decoder.
+		 *
+		 * Each block is decoded with viterbi::viterbi_algorithm(), decoded
+		 * input symbols are written as raw uint16.
+		 *
+		 * \param dec Decoder.
+		 * \param S0 Initial state of each block (-1 if unknown).
+		 * \param SK Final state of each block (-1 if unknown).
+		 * \param in_path Path to the input file, containing branch metrics
+		 *  (O float32 per time index).
+		 * \param out_path Path to the output file (overwritten).
+		 *
+		 * \return Number of decoded time indexes.
+		 */
+		size_t decode(viterbi &dec, int S0, int SK, const std::string &in_path,
+				const std::string &out_path);
+
+		//! Getter for d_block_len.
+		size_t get_block_len() { return d_block_len; }
+		//! Getter for d_queue_depth.
+		size_t get_queue_depth() { return d_queue_depth; }
+};
+
+#endif /* INCLUDED_TURBO_FILE_DECODER_H */
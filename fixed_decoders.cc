@@ -0,0 +1,90 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "fixed_decoders.h"
+
+template<class CODE>
+static viterbi *
+new_fixed_viterbi()
+{
+	return new fixed_viterbi<CODE>();
+}
+
+template<class CODE>
+static log_bcjr_base *
+new_fixed_bcjr(bool max_log)
+{
+	if (max_log) {
+		return new fixed_bcjr<CODE, true>();
+	}
+
+	return new fixed_bcjr<CODE, false>();
+}
+
+//! A code for which specialized decoders are instantiated.
+struct fixed_code
+{
+	const char *name;
+	viterbi *(*make_viterbi)();
+	log_bcjr_base *(*make_bcjr)(bool);
+};
+
+static const fixed_code fixed_codes[] = {
+	{"cc_7_5", new_fixed_viterbi<cc_7_5>, new_fixed_bcjr<cc_7_5>},
+	{"cc_171_133", new_fixed_viterbi<cc_171_133>, new_fixed_bcjr<cc_171_133>},
+	{"lte_cc", new_fixed_viterbi<lte_cc>, new_fixed_bcjr<lte_cc>},
+	{"lte_rsc", new_fixed_viterbi<lte_rsc>, new_fixed_bcjr<lte_rsc>},
+};
+
+static const fixed_code &
+find_fixed_code(const std::string &name)
+{
+	for(const fixed_code &code : fixed_codes) {
+		if (name == code.name) {
+			return code;
+		}
+	}
+
+	throw std::runtime_error("Unknown code: " + name);
+}
+
+std::vector<std::string>
+fixed_code_names()
+{
+	std::vector<std::string> names;
+
+	for(const fixed_code &code : fixed_codes) {
+		names.push_back(code.name);
+	}
+
+	return names;
+}
+
+viterbi *
+make_fixed_viterbi(const std::string &name)
+{
+	return find_fixed_code(name).make_viterbi();
+}
+
+log_bcjr_base *
+make_fixed_bcjr(const std::string &name, bool max_log)
+{
+	return find_fixed_code(name).make_bcjr(max_log);
+}
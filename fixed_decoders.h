@@ -0,0 +1,364 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_FIXED_DECODERS_H
+#define INCLUDED_TURBO_FIXED_DECODERS_H
+
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "conv_trellis.h"
+#include "log_bcjr.h"
+#include "max_log_bcjr.h"
+#include "viterbi.h"
+
+//! Parity of the bits of x (evaluated at compile time).
+constexpr int cc_parity(int x)
+{
+	return (x == 0) ? 0 : ((x & 1) ^ cc_parity(x >> 1));
+}
+
+//! Parity bits of a register for a list of generators (first one in MSB).
+template<int... GENS>
+struct cc_generators;
+
+template<>
+struct cc_generators<>
+{
+	static constexpr int parities(int) { return 0; }
+};
+
+template<int G, int... R>
+struct cc_generators<G, R...>
+{
+	static constexpr int parities(int reg)
+	{
+		return (cc_parity(reg & G) << sizeof...(R))
+			| cc_generators<R...>::parities(reg);
+	}
+};
+
+/*!
+* \brief Compile-time description of a binary convolutional code.
+*
+* Same conventions as conv_trellis: NU is the memory of the code, FEEDBACK
+* the feedback polynomial (0 for a feedforward code) and GENS the generator
+* polynomials.
+*
+* Trellises of such codes are made of butterflies: states 2j and 2j+1 both
+* lead to states j and j+S/2, so that predecessors of a state ns are
+* (2*ns)%S and (2*ns)%S+1, and the most significant bit of ns is the
+* register input of both branches.
+*/
+template<int NU, int FEEDBACK, int... GENS>
+struct conv_code_spec
+{
+	static const int nu = NU;
+	static const int S = 1 << NU;
+	static const int O = 1 << (sizeof...(GENS) + ((FEEDBACK != 0) ? 1 : 0));
+
+	//! Register input of a branch leaving s with input i (and conversely).
+	static constexpr int reg_input(int s, int i)
+	{
+		return i ^ ((FEEDBACK != 0) ? cc_parity(s & FEEDBACK) : 0);
+	}
+
+	//! Next state of the branch leaving s with input i.
+	static constexpr int next_state(int s, int i)
+	{
+		return ((reg_input(s, i) << NU) | s) >> 1;
+	}
+
+	//! Output symbol of the branch leaving s with input i.
+	static constexpr int output(int s, int i)
+	{
+		return (((FEEDBACK != 0) ? i : 0) << sizeof...(GENS))
+			| cc_generators<GENS...>::parities((reg_input(s, i) << NU) | s);
+	}
+
+	//! Builds the (runtime) trellis of the code.
+	static conv_trellis trellis()
+	{
+		conv_trellis t(std::vector<int>({GENS...}), FEEDBACK);
+
+		if (t.get_nu() != NU) {
+			throw std::runtime_error("Invalid memory for the code.");
+		}
+
+		return t;
+	}
+};
+
+/*! The (7,5) code (memory 2), with the output bit order of
+ * examples/75_cc.py (the first output bit is given by generator 5).
+ */
+typedef conv_code_spec<2, 0, 05, 07> cc_7_5;
+//! The K=7 (171,133) code.
+typedef conv_code_spec<6, 0, 0171, 0133> cc_171_133;
+//! The rate 1/3 convolutional code of LTE (3GPP TS 36.212).
+typedef conv_code_spec<6, 0, 0133, 0171, 0165> lte_cc;
+//! The constituent code of the LTE turbo code (feedback 13, parity 15).
+typedef conv_code_spec<3, 013, 015> lte_rsc;
+
+template<class F, int... N>
+inline void static_for_impl(F &f, std::integer_sequence<int, N...>)
+{
+	int unused[] = {0, (f(std::integral_constant<int, N>()), 0)...};
+	(void)unused;
+}
+
+//! Calls f(std::integral_constant<int, n>()) for n = 0, ..., N-1.
+template<int N, class F>
+inline void static_for(F &f)
+{
+	static_for_impl(f, std::make_integer_sequence<int, N>());
+}
+
+/*!
+* \brief Viterbi decoder specialized for a convolutional code known at
+* compile time.
+*
+* The add-compare-select is fully unrolled over the butterflies of the
+* trellis, so that predecessor states and branch metric indexes are
+* constants. Output is identical to viterbi.
+*/
+template<class CODE>
+class fixed_viterbi : public viterbi
+{
+	public:
+		fixed_viterbi() : viterbi(2, CODE::S, CODE::O,
+				CODE::trellis().get_NS(), CODE::trellis().get_OS()) {}
+
+		// Override viterbi method
+		void viterbi_algorithm(int K, int S0, int SK, const float *in,
+				unsigned int *out);
+};
+
+/*!
+* \brief BCJR decoder (log-MAP, or max-log-MAP if MAX_LOG is true)
+* specialized for a convolutional code known at compile time.
+*
+* Forward, backward and APP steps are fully unrolled over the butterflies of
+* the trellis, so that states and branch metric indexes are constants.
+* Everything else (bidirectional schedule, storage formats, puncturing,
+* streaming) is inherited from log_bcjr_base. Output is identical to
+* log_bcjr (or max_log_bcjr).
+*/
+template<class CODE, bool MAX_LOG>
+class fixed_bcjr : public log_bcjr_base
+{
+	private:
+		static inline float max_star(float A, float B)
+		{
+			return MAX_LOG ? max_log_bcjr::max(A, B) : log_bcjr::max_star(A, B);
+		}
+
+		static inline float max_star(const float *vec, size_t n_ele)
+		{
+			return MAX_LOG ? max_log_bcjr::max(vec, n_ele)
+				: log_bcjr::max_star(vec, n_ele);
+		}
+
+	public:
+		fixed_bcjr() : log_bcjr_base(2, CODE::S, CODE::O,
+				CODE::trellis().get_NS(), CODE::trellis().get_OS()) {}
+
+		// Override log_bcjr_base method
+		float _max_star(float A, float B) { return max_star(A, B); }
+		// Override log_bcjr_base method
+		float _max_star(const float *vec, size_t n_ele) { return max_star(vec, n_ele); }
+
+		// Override log_bcjr_base method
+		void forward_step(const float *G_k, const float *A_prev, float *A_curr);
+		// Override log_bcjr_base method
+		void backward_step(const float *G_k, const float *B_next, float *B_curr);
+		// Override log_bcjr_base method
+		void app_step(const float *A_k, const float *B_next, const float *G_k,
+				float *out_k);
+};
+
+template<class CODE>
+void
+fixed_viterbi<CODE>::viterbi_algorithm(int K, int S0, int SK, const float *in,
+		unsigned int *out)
+{
+	const int S = CODE::S;
+	const int n_words = (S+63)/64;
+
+	int tb_state;
+	float min_metric;
+
+	std::vector<uint64_t> trace(K*n_words, 0);
+	float alpha_prev[S], alpha_curr[S];
+
+	PERF_ADD(get_perf_counters(), PERF_CALLS, 1);
+	PERF_ADD(get_perf_counters(), PERF_STEPS, K);
+	PERF_ADD(get_perf_counters(), PERF_BYTES_ALLOCATED,
+			K*n_words*sizeof(uint64_t));
+
+	//If initial state was specified
+	if(S0 != -1) {
+		std::fill(alpha_prev, alpha_prev + S, std::numeric_limits<float>::max());
+		alpha_prev[S0] = 0.0;
+	}
+	else {
+		std::fill(alpha_prev, alpha_prev + S, 0.0);
+	}
+
+	PERF_TIMESTAMP(acs_start);
+	for(int k=0 ; k < K ; ++k) {
+		const float *in_k = in + k*CODE::O;
+		uint64_t *trace_k = &trace[k*n_words];
+
+		min_metric = std::numeric_limits<float>::max();
+
+		auto acs = [&](auto ns_c) {
+			constexpr int ns = decltype(ns_c)::value;
+			constexpr int a = ns >> (CODE::nu - 1);
+			constexpr int p0 = (ns << 1) & (CODE::S - 1);
+			constexpr int p1 = p0 | 1;
+			constexpr int o0 = CODE::output(p0, CODE::reg_input(p0, a));
+			constexpr int o1 = CODE::output(p1, CODE::reg_input(p1, a));
+
+			//ADD
+			float m0 = alpha_prev[p0] + in_k[o0];
+			float m1 = alpha_prev[p1] + in_k[o1];
+
+			//COMPARE
+			bool dec = m1 < m0;
+
+			//SELECT
+			alpha_curr[ns] = dec ? m1 : m0;
+			trace_k[ns/64] |= (uint64_t)dec << (ns%64);
+			min_metric = std::min(min_metric, alpha_curr[ns]);
+		};
+		static_for<CODE::S>(acs);
+
+		//Metrics normalization
+		for(int s=0 ; s < S ; ++s) {
+			alpha_prev[s] = alpha_curr[s] - min_metric;
+		}
+	}
+	PERF_ELAPSED(get_perf_counters(), PERF_ACS, acs_start);
+
+	//If final state was specified
+	if(SK != -1) {
+		tb_state = SK;
+	}
+	else{
+		tb_state = (int)(std::min_element(alpha_prev, alpha_prev + S) - alpha_prev);
+	}
+
+	//Traceback
+	PERF_SCOPE(get_perf_counters(), PERF_TRACEBACK);
+	for(int k=K-1 ; k >= 0 ; --k) {
+		int dec = (trace[k*n_words + tb_state/64] >> (tb_state%64)) & 1;
+		int prev_state = ((tb_state << 1) & (S-1)) | dec;
+
+		out[k] = (unsigned int)CODE::reg_input(prev_state,
+				tb_state >> (CODE::nu - 1));
+		tb_state = prev_state;
+	}
+}
+
+template<class CODE, bool MAX_LOG>
+void
+fixed_bcjr<CODE, MAX_LOG>::forward_step(const float *G_k, const float *A_prev,
+		float *A_curr)
+{
+	auto step = [&](auto ns_c) {
+		constexpr int ns = decltype(ns_c)::value;
+		constexpr int a = ns >> (CODE::nu - 1);
+		constexpr int p0 = (ns << 1) & (CODE::S - 1);
+		constexpr int p1 = p0 | 1;
+
+		A_curr[ns] = max_star(
+				A_prev[p0] + G_k[CODE::output(p0, CODE::reg_input(p0, a))],
+				A_prev[p1] + G_k[CODE::output(p1, CODE::reg_input(p1, a))]);
+	};
+	static_for<CODE::S>(step);
+
+	//Metrics normalization
+	float norm_A = max_star(A_curr, CODE::S);
+	for(int s=0 ; s < CODE::S ; ++s) {
+		A_curr[s] -= norm_A;
+	}
+}
+
+template<class CODE, bool MAX_LOG>
+void
+fixed_bcjr<CODE, MAX_LOG>::backward_step(const float *G_k, const float *B_next,
+		float *B_curr)
+{
+	auto step = [&](auto s_c) {
+		constexpr int s = decltype(s_c)::value;
+
+		B_curr[s] = max_star(
+				B_next[CODE::next_state(s, 0)] + G_k[CODE::output(s, 0)],
+				B_next[CODE::next_state(s, 1)] + G_k[CODE::output(s, 1)]);
+	};
+	static_for<CODE::S>(step);
+
+	//Metrics normalization
+	float norm_B = max_star(B_curr, CODE::S);
+	for(int s=0 ; s < CODE::S ; ++s) {
+		B_curr[s] -= norm_B;
+	}
+}
+
+template<class CODE, bool MAX_LOG>
+void
+fixed_bcjr<CODE, MAX_LOG>::app_step(const float *A_k, const float *B_next,
+		const float *G_k, float *out_k)
+{
+	auto step = [&](auto s_c) {
+		constexpr int s = decltype(s_c)::value;
+
+		out_k[2*s] = B_next[CODE::next_state(s, 0)] + G_k[CODE::output(s, 0)]
+			+ A_k[s];
+		out_k[2*s+1] = B_next[CODE::next_state(s, 1)] + G_k[CODE::output(s, 1)]
+			+ A_k[s];
+	};
+	static_for<CODE::S>(step);
+}
+
+//! Names of the codes for which specialized decoders are available.
+std::vector<std::string> fixed_code_names();
+
+/*! Instantiates the specialized Viterbi decoder of a code.
+ *
+ * \param name Name of the code (see fixed_code_names()).
+ *
+ * \return A new decoder, to be deleted by the caller.
+ */
+viterbi *make_fixed_viterbi(const std::string &name);
+
+/*! Instantiates the specialized BCJR decoder of a code.
+ *
+ * \param name Name of the code (see fixed_code_names()).
+ * \param max_log If true, a max-log-MAP decoder is returned, otherwise a
+ *  log-MAP decoder.
+ *
+ * \return A new decoder, to be deleted by the caller.
+ */
+log_bcjr_base *make_fixed_bcjr(const std::string &name, bool max_log);
+
+#endif /* INCLUDED_TURBO_FIXED_DECODERS_H */
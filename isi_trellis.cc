@@ -0,0 +1,138 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "isi_trellis.h"
+
+isi_trellis::isi_trellis(const std::vector<std::complex<float> > &taps,
+		const std::vector<std::complex<float> > &constellation)
+	: d_M(constellation.size()), d_L((int)taps.size() - 1)
+{
+	if (taps.empty()) {
+		throw std::runtime_error("Invalid size for taps.");
+	}
+
+	if (constellation.empty()) {
+		throw std::runtime_error("Invalid size for constellation.");
+	}
+
+	//O = M^(L+1) must fit in an int
+	d_S = 1;
+	for(int l=0 ; l < d_L ; ++l) {
+		if (d_S > INT_MAX/d_M) {
+			throw std::runtime_error("Invalid size: too many states.");
+		}
+		d_S *= d_M;
+	}
+	if (d_S > INT_MAX/d_M) {
+		throw std::runtime_error("Invalid size: too many states.");
+	}
+	d_O = d_S*d_M;
+
+	d_NS.resize(d_S*d_M);
+	d_OS.resize(d_S*d_M);
+	d_out_re.resize(d_O);
+	d_out_im.resize(d_O);
+
+	for(int s=0 ; s < d_S ; ++s) {
+		//Contribution of past symbols x_{k-1}, ..., x_{k-L}
+		std::complex<float> y_past = 0.0;
+		int past = s;
+		for(int l=1 ; l <= d_L ; ++l) {
+			y_past += taps[l]*constellation[past % d_M];
+			past /= d_M;
+		}
+
+		for(int i=0 ; i < d_M ; ++i) {
+			std::complex<float> y = y_past + taps[0]*constellation[i];
+
+			d_NS[s*d_M+i] = (s*d_M + i) % d_S;
+			d_OS[s*d_M+i] = s*d_M + i;
+			d_out_re[s*d_M+i] = y.real();
+			d_out_im[s*d_M+i] = y.imag();
+		}
+	}
+}
+
+void
+isi_trellis::euclidean_metrics(std::complex<float> r_k, float inv_sigma2,
+		float *G_k)
+{
+	const float r_re = r_k.real();
+	const float r_im = r_k.imag();
+	const float *out_re = &d_out_re[0];
+	const float *out_im = &d_out_im[0];
+
+	for(int o=0 ; o < d_O ; ++o) {
+		float d_re = r_re - out_re[o];
+		float d_im = r_im - out_im[o];
+
+		G_k[o] = -(d_re*d_re + d_im*d_im)*inv_sigma2;
+	}
+}
+
+void
+isi_trellis::branch_metrics(const std::complex<float> *r, size_t K,
+		float sigma2, const float *apriori, float *G)
+{
+	const float inv_sigma2 = 1.0/sigma2;
+
+	for(size_t k=0 ; k < K ; ++k) {
+		euclidean_metrics(r[k], inv_sigma2, G);
+
+		//Outputs are ordered as o = s*M + i, so that the a-priori term only
+		//depends on the position in each block of M outputs
+		if (apriori != NULL) {
+			const float *P_k = apriori + k*d_M;
+
+			for(int o=0 ; o < d_O ; o += d_M) {
+				for(int i=0 ; i < d_M ; ++i) {
+					G[o+i] += P_k[i];
+				}
+			}
+		}
+
+		G += d_O;
+	}
+}
+
+void
+isi_trellis::branch_metrics_llr(const std::complex<float> *r, size_t K,
+		float sigma2, const float *llr, float *G)
+{
+	if (d_M != 2) {
+		throw std::runtime_error("A-priori LLRs require a binary constellation.");
+	}
+
+	const float inv_sigma2 = 1.0/sigma2;
+
+	for(size_t k=0 ; k < K ; ++k) {
+		const float half_llr = 0.5*llr[k];
+
+		euclidean_metrics(r[k], inv_sigma2, G);
+
+		//Even outputs carry symbol 0, odd outputs symbol 1
+		for(int o=0 ; o < d_O ; o += 2) {
+			G[o] += half_llr;
+			G[o+1] -= half_llr;
+		}
+
+		G += d_O;
+	}
+}
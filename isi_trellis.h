@@ -0,0 +1,130 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_ISI_TRELLIS_H
+#define INCLUDED_TURBO_ISI_TRELLIS_H
+
+#include <climits>
+#include <complex>
+#include <vector>
+#include <stdexcept>
+
+/*!
+* \brief Trellis of an intersymbol interference (ISI) channel, and the
+* associated branch metrics.
+*
+* For a channel with L+1 taps h_0, ..., h_L and a constellation of M
+* symbols c_0, ..., c_{M-1}, the trellis has:
+* - I = M inputs (the transmitted symbol x_k),
+* - S = M^L states: s = x_{k-1} + M*x_{k-2} + ... + M^{L-1}*x_{k-L},
+* - O = M^{L+1} outputs: o = s*M + x_k, whose noiseless channel output is
+*   y_o = h_0*c_{x_k} + h_1*c_{x_{k-1}} + ... + h_L*c_{x_{k-L}}.
+*
+* NS and OS can be given to log_bcjr, max_log_bcjr or viterbi, which makes
+* this class suitable for (turbo-)equalization.
+*/
+class isi_trellis
+{
+	private:
+		//! The number of symbols in the constellation.
+		int d_M;
+		//! The memory of the channel (number of taps minus one).
+		int d_L;
+		//! The number of states in the trellis.
+		int d_S;
+		//! The number of possible outputs.
+		int d_O;
+
+		//! Next state: NS[s*M+i]=ns.
+		std::vector<int> d_NS;
+		//! Output symbol: OS[s*M+i]=os.
+		std::vector<int> d_OS;
+
+		//! Real part of the noiseless channel output of each output symbol.
+		std::vector<float> d_out_re;
+		//! Imaginary part of the noiseless channel output of each output symbol.
+		std::vector<float> d_out_im;
+
+		//! Computes the euclidean term of the O branch metrics of sample r_k.
+		void euclidean_metrics(std::complex<float> r_k, float inv_sigma2,
+				float *G_k);
+
+	public:
+		/*! Constructs an isi_trellis object.
+		 *
+		 * Throws std::runtime_error if the number of outputs M^(L+1) does
+		 * not fit in an int.
+		 *
+		 * \param taps Channel taps h_0, ..., h_L.
+		 * \param constellation Constellation symbols c_0, ..., c_{M-1}.
+		 */
+		isi_trellis(const std::vector<std::complex<float> > &taps,
+				const std::vector<std::complex<float> > &constellation);
+
+		//! Computes log branch metrics from received samples.
+		/*!
+		 * For each time index k and output symbol o = s*M + i:
+		 *
+		 * G_k(o) = -|r_k - y_o|^2/sigma2 + P_k(i)
+		 *
+		 * where P_k(i) is the a-priori log-probability of symbol i at time
+		 * index k, up to an additive constant (e.g. {LLR/2, -LLR/2} for a
+		 * binary constellation with a-priori LLR LLR). The result can be
+		 * directly used as the input of log_bcjr or max_log_bcjr.
+		 *
+		 * \param r Received samples (size: K).
+		 * \param K Number of received samples.
+		 * \param sigma2 Variance of the complex noise.
+		 * \param apriori A-priori symbol log-probabilities (size: M*K), or
+		 *  NULL if there is no a-priori information.
+		 * \param G Log branch metrics (size: O*K).
+		 */
+		void branch_metrics(const std::complex<float> *r, size_t K, float sigma2,
+				const float *apriori, float *G);
+
+		//! Computes log branch metrics from received samples and binary LLRs.
+		/*!
+		 * Same as branch_metrics(), for a binary constellation (M = 2),
+		 * with a-priori information given as one LLR per symbol,
+		 * LLR_k = log(P(x_k = c_0)/P(x_k = c_1)), so that
+		 * P_k = {LLR_k/2, -LLR_k/2}. Throws std::runtime_error if M != 2.
+		 *
+		 * \param r Received samples (size: K).
+		 * \param K Number of received samples.
+		 * \param sigma2 Variance of the complex noise.
+		 * \param llr A-priori LLRs (size: K).
+		 * \param G Log branch metrics (size: O*K).
+		 */
+		void branch_metrics_llr(const std::complex<float> *r, size_t K,
+				float sigma2, const float *llr, float *G);
+
+		//! Getter for the number of inputs (M).
+		int get_I() { return d_M; }
+		//! Getter for d_S.
+		int get_S() { return d_S; }
+		//! Getter for d_O.
+		int get_O() { return d_O; }
+		//! Getter for d_NS.
+		std::vector<int>& get_NS() { return d_NS; }
+		//! Getter for d_OS.
+		std::vector<int>& get_OS() { return d_OS; }
+};
+
+#endif /* INCLUDED_TURBO_ISI_TRELLIS_H */
@@ -23,7 +23,8 @@
 log_bcjr_base::log_bcjr_base(int I, int S, int O,
 		const std::vector<int> &NS,
 		const std::vector<int> &OS)
-	: d_I(I), d_S(S), d_O(O), d_ordered_OS(S*I)
+	: d_I(I), d_S(S), d_O(O), d_ordered_OS(S*I),
+	  d_bidirectional(false), d_storage(METRIC_FLOAT32)
 {
 	if (NS.size() != S*I) {
 		throw std::runtime_error("Invalid size for NS.");
@@ -70,92 +71,101 @@ log_bcjr_base::generate_PS_PI()
 }
 
 void
-log_bcjr_base::compute_fw_metrics(const std::vector<float> &G,
-		const std::vector<float> &A0, std::vector<float> &A, size_t K)
+log_bcjr_base::prepare_metrics(const float *in, float *out, size_t n_ele,
+		size_t n_blocks)
 {
-	A.resize(d_S*(K+1), -std::numeric_limits<float>::max());
+	std::copy(in, in + n_ele*n_blocks, out);
+}
 
-	float norm_A = -std::numeric_limits<float>::max();
-	std::vector<float>::iterator A_prev, A_curr;
-	std::vector<int>::iterator PS_it, ordered_OS_it;
+void
+log_bcjr_base::forward_step(const float *G_k, const float *A_prev,
+		float *A_curr)
+{
+	std::vector<int>::const_iterator PS_it;
+	std::vector<int>::const_iterator ordered_OS_it = d_ordered_OS.begin();
 
-	//Integrate initial forward metrics
-	std::copy(A0.begin(), A0.end(), A.begin());
+	for(int s=0 ; s < d_S ; ++s) {
+		//Iterators for previous state and previous input lists
+		PS_it=d_PS[s].begin();
 
-	//Initialize iterators
-	A_prev = A.begin();
-	A_curr = A.begin() + d_S;
-	for(std::vector<float>::const_iterator G_k = G.begin() ;
-			G_k != G.end() ; G_k += d_O) {
-
-        ordered_OS_it = d_ordered_OS.begin();
-		for(int s=0 ; s < d_S ; ++s) {
-			//Iterators for previous state and previous input lists
-			PS_it=d_PS[s].begin();
-
-			//Loop
-			for(size_t i=0 ; i<(d_PS[s]).size() ; ++i) {
-				// Equivalent to:
-				// *A_curr = _max_star(*A_curr,
-				// A_prev[PS[s][i]] + G_k[d_OS[PS[s][i]*I + PI[s][i]]);
-				*A_curr = _max_star(*A_curr,
-						A_prev[*(PS_it++)] + G_k[*(ordered_OS_it++)]);
-			}
+		//Loop
+		A_curr[s] = -std::numeric_limits<float>::max();
+		for(size_t i=0 ; i<(d_PS[s]).size() ; ++i) {
+			// Equivalent to:
+			// A_curr[s] = _max_star(A_curr[s],
+			// A_prev[PS[s][i]] + G_k[d_OS[PS[s][i]*I + PI[s][i]]);
+			A_curr[s] = _max_star(A_curr[s],
+					A_prev[*(PS_it++)] + G_k[*(ordered_OS_it++)]);
+		}
+	}
+
+	//Metrics normalization
+	float norm_A = _max_star(A_curr, d_S);
+	std::transform(A_curr, A_curr + d_S, A_curr,
+			std::bind2nd(std::minus<float>(), norm_A));
+}
 
-			//Update iterators
-			++A_curr;
+void
+log_bcjr_base::backward_step(const float *G_k, const float *B_next,
+		float *B_curr)
+{
+	std::vector<int>::const_iterator NS_it = d_NS.begin();
+	std::vector<int>::const_iterator OS_it = d_OS.begin();
+
+	for(int s=0 ; s < d_S ; ++s) {
+		B_curr[s] = -std::numeric_limits<float>::max();
+		for(int i=0 ; i < d_I ; ++i) {
+			B_curr[s] = _max_star(B_curr[s],
+					B_next[*(NS_it++)] + G_k[*(OS_it++)]);
 		}
+	}
 
-		//Advance A_prev
-		A_prev += d_S;
+	//Metrics normalization
+	float norm_B = _max_star(B_curr, d_S);
+	std::transform(B_curr, B_curr + d_S, B_curr,
+			std::bind2nd(std::minus<float>(), norm_B));
+}
 
-		//Metrics normalization
-		norm_A = _max_star(&(*(A_prev)), d_S);
-		std::transform(A_prev, A_curr, A_prev,
-				std::bind2nd(std::minus<float>(), norm_A));
+void
+log_bcjr_base::app_step(const float *A_k, const float *B_next,
+		const float *G_k, float *out_k)
+{
+	for(int s=0 ; s < d_S ; ++s) {
+		for (int i=0 ; i < d_I ; ++i) {
+			*(out_k++) = B_next[d_NS[s*d_I+i]] + G_k[d_OS[s*d_I+i]] + A_k[s];
+		}
 	}
 }
 
 void
-log_bcjr_base::compute_bw_metrics(const std::vector<float> &G,
-		const std::vector<float> &BK, std::vector<float> &B, size_t K)
+log_bcjr_base::compute_fw_metrics(const std::vector<float> &G,
+		const std::vector<float> &A0, std::vector<float> &A, size_t K)
 {
-	B.resize(d_S*(K+1), -std::numeric_limits<float>::max());
+	PERF_SCOPE(d_perf, PERF_FW_METRICS);
 
-	float norm_B = -std::numeric_limits<float>::max();
-	std::vector<float>::reverse_iterator B_next, B_curr;
-	std::vector<int>::reverse_iterator NS_it, OS_it;
+	A.resize(d_S*(K+1));
 
 	//Integrate initial forward metrics
-	std::copy(BK.rbegin(), BK.rend(), B.rbegin());
-
-	//Initialize iterators
-	B_curr = B.rbegin() + d_S;
-	B_next = B.rbegin();
-	for(std::vector<float>::const_reverse_iterator G_k = G.rbegin() ;
-			G_k != G.rend() ; G_k += d_O) {
-
-		//Iterators for next state and next output lists
-		NS_it=d_NS.rbegin();
-		OS_it=d_OS.rbegin();
-		for(int s=0 ; s < d_S ; ++s) {
-			//Loop
-			for(size_t i=0 ; i < d_I ; ++i) {
-				*B_curr = _max_star(*B_curr,
-						B_next[(d_S-1)-*(NS_it++)] + G_k[(d_O-1)-*(OS_it++)]);
-			}
+	std::copy(A0.begin(), A0.end(), A.begin());
 
-			//Update iterators
-			++B_curr;
-		}
+	for(size_t k=0 ; k < K ; ++k) {
+		forward_step(&G[k*d_O], &A[k*d_S], &A[(k+1)*d_S]);
+	}
+}
+
+void
+log_bcjr_base::compute_bw_metrics(const std::vector<float> &G,
+		const std::vector<float> &BK, std::vector<float> &B, size_t K)
+{
+	PERF_SCOPE(d_perf, PERF_BW_METRICS);
 
-		//Advance B_next (go back, as it is a reverse iterator...)
-		B_next += d_S;
+	B.resize(d_S*(K+1));
 
-		//Metrics normalization
-		norm_B = _max_star(&(*B_curr)+1, d_S);
-		std::transform(B_next, B_curr, B_next,
-				std::bind2nd(std::minus<float>(), norm_B));
+	//Integrate final backward metrics
+	std::copy(BK.begin(), BK.end(), B.begin() + K*d_S);
+
+	for(size_t k=K ; k > 0 ; --k) {
+		backward_step(&G[(k-1)*d_O], &B[k*d_S], &B[(k-1)*d_S]);
 	}
 }
 
@@ -163,43 +173,297 @@ void
 log_bcjr_base::compute_app(const std::vector<float> &A, const std::vector<float> &B,
 		const std::vector<float> &G, size_t K, std::vector<float> &out)
 {
-	std::vector<float>::const_iterator A_it = A.begin();
-	std::vector<float>::const_iterator B_it = B.begin() + d_S;
+	PERF_SCOPE(d_perf, PERF_APP);
+
+	out.resize(d_S*d_I*K);
+
+	for(size_t k=0 ; k < K ; ++k) {
+		app_step(&A[k*d_S], &B[(k+1)*d_S], &G[k*d_O], &out[k*d_S*d_I]);
+	}
+}
+
+void
+log_bcjr_base::log_bcjr_algorithm_bidir(const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::vector<float> &in,
+		std::vector<float> &out, size_t K)
+{
+	std::vector<float> A(d_S*(K+1)), B(d_S*(K+1));
+	const size_t M = K/2;
 
-	out.reserve(d_S*d_I*K);
+	//Each thread signals when it has reached the middle of the block
+	std::promise<void> fw_half, bw_half;
+	std::future<void> fw_half_done = fw_half.get_future();
+	std::future<void> bw_half_done = bw_half.get_future();
 
-	for(std::vector<float>::const_iterator G_k = G.begin() ;
-			G_k != G.end() ; G_k += d_O) {
+	out.resize(d_S*d_I*K);
 
-		for(int s=0 ; s < d_S ; ++s) {
-			for (int i=0 ; i < d_I ; ++i) {
-				out.push_back(B_it[d_NS[s*d_I+i]] + G_k[d_OS[s*d_I+i]] + *A_it);
+	std::copy(A0.begin(), A0.end(), A.begin());
+	std::copy(BK.begin(), BK.end(), B.begin() + K*d_S);
+
+	//Failure of the backward thread after it has signalled fw_half
+	std::exception_ptr bw_error;
+
+	//Backward recursion, then APPs of [0 ; M[
+	std::thread bw_thread([&]() {
+		bool half_signalled = false;
+
+		try {
+			{
+				PERF_SCOPE(d_perf, PERF_BW_METRICS);
+				for(size_t k=K ; k > M ; --k) {
+					backward_step(&in[(k-1)*d_O], &B[k*d_S], &B[(k-1)*d_S]);
+				}
 			}
 
-			//Update forward iterator
-			++A_it;
+			bw_half.set_value();
+			half_signalled = true;
+			//Rethrows the failure of the forward recursion, if any
+			fw_half_done.get();
+
+			PERF_SCOPE(d_perf, PERF_FUSED_APP);
+			for(size_t k=M ; k > 0 ; --k) {
+				app_step(&A[(k-1)*d_S], &B[k*d_S], &in[(k-1)*d_O],
+						&out[(k-1)*d_S*d_I]);
+				if (k > 1) {
+					backward_step(&in[(k-1)*d_O], &B[k*d_S], &B[(k-1)*d_S]);
+				}
+			}
 		}
+		catch (...) {
+			if (half_signalled) {
+				bw_error = std::current_exception();
+			}
+			else {
+				bw_half.set_exception(std::current_exception());
+			}
+		}
+	});
+
+	//Forward recursion, then APPs of [M ; K[
+	bool half_signalled = false;
+
+	try {
+		{
+			PERF_SCOPE(d_perf, PERF_FW_METRICS);
+			for(size_t k=0 ; k < M ; ++k) {
+				forward_step(&in[k*d_O], &A[k*d_S], &A[(k+1)*d_S]);
+			}
+		}
+
+		fw_half.set_value();
+		half_signalled = true;
+		//Rethrows the failure of the backward recursion, if any
+		bw_half_done.get();
+
+		PERF_SCOPE(d_perf, PERF_FUSED_APP);
+		for(size_t k=M ; k < K ; ++k) {
+			app_step(&A[k*d_S], &B[(k+1)*d_S], &in[k*d_O], &out[k*d_S*d_I]);
+			if (k < K-1) {
+				forward_step(&in[k*d_O], &A[k*d_S], &A[(k+1)*d_S]);
+			}
+		}
+	}
+	catch (...) {
+		//Never leave the backward thread waiting, nor joinable
+		if (!half_signalled) {
+			fw_half.set_exception(std::current_exception());
+		}
+		bw_thread.join();
+		throw;
+	}
+
+	bw_thread.join();
 
-		//Update backward iterator
-		B_it += d_S;
+	if (bw_error) {
+		std::rethrow_exception(bw_error);
 	}
 }
 
 void
-log_bcjr_base::log_bcjr_algorithm(const std::vector<float> &A0,
+log_bcjr_base::log_bcjr_algorithm_packed(const std::vector<float> &A0,
 		const std::vector<float> &BK, const std::vector<float> &in,
+		std::vector<float> &out, size_t K)
+{
+	std::vector<uint16_t> A(d_S*(K+1));
+	std::vector<float> A_prev(A0), A_curr(d_S);
+	std::vector<float> B_next(BK), B_curr(d_S);
+
+	out.resize(d_S*d_I*K);
+
+	//Forward recursion
+	{
+		PERF_SCOPE(d_perf, PERF_FW_METRICS);
+
+		pack_metrics(d_storage, &A_prev[0], d_S, &A[0]);
+		for(size_t k=0 ; k < K ; ++k) {
+			forward_step(&in[k*d_O], &A_prev[0], &A_curr[0]);
+			pack_metrics(d_storage, &A_curr[0], d_S, &A[(k+1)*d_S]);
+			A_prev.swap(A_curr);
+		}
+	}
+
+	//Backward recursion, and branch APP
+	PERF_SCOPE(d_perf, PERF_FUSED_APP);
+	for(size_t k=K ; k > 0 ; --k) {
+		unpack_metrics(d_storage, &A[(k-1)*d_S], d_S, &A_curr[0]);
+		app_step(&A_curr[0], &B_next[0], &in[(k-1)*d_O],
+				&out[(k-1)*d_S*d_I]);
+
+		if (k > 1) {
+			backward_step(&in[(k-1)*d_O], &B_next[0], &B_curr[0]);
+			B_next.swap(B_curr);
+		}
+	}
+}
+
+void
+log_bcjr_base::log_bcjr_recursions(const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::vector<float> &G,
 		std::vector<float> &out)
 {
 	std::vector<float> A, B;
-	size_t K = in.size()/d_O;
+	size_t K = G.size()/d_O;
+
+	PERF_ADD(d_perf, PERF_CALLS, 1);
+	PERF_ADD(d_perf, PERF_STEPS, K);
+
+	//Reduced-precision storage of forward metrics
+	if (d_storage != METRIC_FLOAT32) {
+		PERF_ADD(d_perf, PERF_BYTES_ALLOCATED, d_S*(K+1)*sizeof(uint16_t)
+				+ (4*d_S + d_S*d_I*K)*sizeof(float));
+
+		log_bcjr_algorithm_packed(A0, BK, G, out, K);
+		return;
+	}
+
+	PERF_ADD(d_perf, PERF_BYTES_ALLOCATED,
+			(2*d_S*(K+1) + d_S*d_I*K)*sizeof(float));
+
+	//Concurrent forward/backward recursions
+	if (d_bidirectional && K >= 2) {
+		log_bcjr_algorithm_bidir(A0, BK, G, out, K);
+		return;
+	}
 
 	//Forward recursion
-	compute_fw_metrics(in, A0, A, K);
+	compute_fw_metrics(G, A0, A, K);
 
 	//Backward recursion
-	compute_bw_metrics(in, BK, B, K);
+	compute_bw_metrics(G, BK, B, K);
 
 	//Compute branch APP
-	compute_app(A, B, in, K, out);
+	compute_app(A, B, G, K, out);
+}
+
+void
+log_bcjr_base::log_bcjr_algorithm(const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::vector<float> &in,
+		std::vector<float> &out)
+{
+	log_bcjr_recursions(A0, BK, in, out);
+}
+
+void
+log_bcjr_base::log_bcjr_algorithm_punctured(const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::vector<float> &llr,
+		const puncturing_pattern &pattern, size_t K, std::vector<float> &out)
+{
+	//Forward metrics are stored either in A, or in A_packed (see set_storage())
+	const bool packed = (d_storage != METRIC_FLOAT32);
+	std::vector<float> A(packed ? 0 : d_S*(K+1));
+	std::vector<uint16_t> A_packed(packed ? d_S*(K+1) : 0);
+	std::vector<float> A_prev(d_S), A_curr(d_S), B_next(d_S), B_curr(d_S);
+	std::vector<float> G_log(d_O), G_k(d_O);
+
+	if ((1 << pattern.get_n()) != d_O) {
+		throw std::runtime_error("Invalid puncturing pattern for this trellis.");
+	}
+
+	if (llr.size() < pattern.get_n_soft(K)) {
+		throw std::runtime_error("Invalid size for llr.");
+	}
+
+	out.resize(d_S*d_I*K);
+
+	PERF_ADD(d_perf, PERF_CALLS, 1);
+	PERF_ADD(d_perf, PERF_STEPS, K);
+	PERF_ADD(d_perf, PERF_BYTES_ALLOCATED, A.size()*sizeof(float)
+			+ A_packed.size()*sizeof(uint16_t)
+			+ (4*d_S + 2*d_O + d_S*d_I*K)*sizeof(float));
+
+	//Forward recursion
+	{
+		PERF_SCOPE(d_perf, PERF_FW_METRICS);
+
+		if (packed) {
+			prepare_metrics(&A0[0], &A_prev[0], d_S, 1);
+			pack_metrics(d_storage, &A_prev[0], d_S, &A_packed[0]);
+		}
+		else {
+			prepare_metrics(&A0[0], &A[0], d_S, 1);
+		}
+
+		for(size_t k=0 ; k < K ; ++k) {
+			pattern.branch_metrics(llr.data(), k, &G_log[0], 1.0);
+			prepare_metrics(&G_log[0], &G_k[0], d_O, 1);
+
+			if (packed) {
+				forward_step(&G_k[0], &A_prev[0], &A_curr[0]);
+				pack_metrics(d_storage, &A_curr[0], d_S, &A_packed[(k+1)*d_S]);
+				A_prev.swap(A_curr);
+			}
+			else {
+				forward_step(&G_k[0], &A[k*d_S], &A[(k+1)*d_S]);
+			}
+		}
+	}
+
+	//Backward recursion, and branch APP
+	PERF_SCOPE(d_perf, PERF_FUSED_APP);
+	prepare_metrics(&BK[0], &B_next[0], d_S, 1);
+	for(size_t k=K ; k > 0 ; --k) {
+		const float *A_k = &A_curr[0];
+
+		pattern.branch_metrics(llr.data(), k-1, &G_log[0], 1.0);
+		prepare_metrics(&G_log[0], &G_k[0], d_O, 1);
+
+		if (packed) {
+			unpack_metrics(d_storage, &A_packed[(k-1)*d_S], d_S, &A_curr[0]);
+		}
+		else {
+			A_k = &A[(k-1)*d_S];
+		}
+
+		app_step(A_k, &B_next[0], &G_k[0], &out[(k-1)*d_S*d_I]);
+
+		backward_step(&G_k[0], &B_next[0], &B_curr[0]);
+		B_next.swap(B_curr);
+	}
 }
 
+void
+log_bcjr_base::compute_llr(const std::vector<float> &app, std::vector<float> &llr)
+{
+	size_t K = app.size()/(d_S*d_I);
+	std::vector<float> app_i(d_S);
+	float app_0;
+
+	llr.resize((d_I-1)*K);
+
+	for(size_t k=0 ; k < K ; ++k) {
+		const float *app_k = &app[k*d_S*d_I];
+
+		for(int i=0 ; i < d_I ; ++i) {
+			for(int s=0 ; s < d_S ; ++s) {
+				app_i[s] = app_k[s*d_I + i];
+			}
+
+			if (i == 0) {
+				app_0 = _max_star(&app_i[0], d_S);
+			}
+			else {
+				llr[k*(d_I-1) + i-1] = app_0 - _max_star(&app_i[0], d_S);
+			}
+		}
+	}
+}
@@ -28,6 +28,13 @@
 #include <stdexcept>
 #include <cmath>
 #include <cfloat>
+#include <exception>
+#include <future>
+#include <thread>
+
+#include "metric_storage.h"
+#include "perf_counters.h"
+#include "puncturing_pattern.h"
 
 /*!
 * \brief <+description+>
@@ -35,7 +42,7 @@
 */
 class log_bcjr_base
 {
-	private:
+	protected:
 		//! The number of possible input sequences (e.g. 2 for binary codes).
 		int d_I;
 		//! The number of states in the trellis.
@@ -68,9 +75,57 @@ class log_bcjr_base
 		//! Defined such that d_PI[s] contains all the inputs yielding to state s.
 		std::vector<std::vector<int> > d_PI;
 
+		//! Whether log_bcjr_algorithm() runs both recursions concurrently.
+		bool d_bidirectional;
+
+		//! Format in which log_bcjr_algorithm() stores forward metrics.
+		metric_storage d_storage;
+
+		//! Performance counters.
+		perf_counters d_perf;
+
 		//! Generates PS, PI and T tables.
 		void generate_PS_PI();
 
+		/*! Runs the forward and backward recursions on two threads.
+		 *
+		 * The forward recursion starts from k=0 and the backward recursion
+		 * from k=K. Once both have reached the middle of the block, the
+		 * forward thread emits the APPs of the second half while the backward
+		 * thread emits the APPs of the first half.
+		 */
+		void log_bcjr_algorithm_bidir(const std::vector<float> &A0,
+				const std::vector<float> &BK,
+				const std::vector<float> &in,
+				std::vector<float> &out, size_t K);
+
+		/*! Runs the forward recursion, storing forward metrics in the format
+		 * selected by set_storage(), then the backward recursion, computing
+		 * APPs on the fly (backward metrics are not stored).
+		 */
+		void log_bcjr_algorithm_packed(const std::vector<float> &A0,
+				const std::vector<float> &BK,
+				const std::vector<float> &in,
+				std::vector<float> &out, size_t K);
+
+		/*! Runs the forward and backward recursions, and computes the
+		 * APPs, with the schedule selected by set_bidirectional() and
+		 * set_storage().
+		 *
+		 * Metrics are passed as expected by forward_step(), backward_step()
+		 * and app_step().
+		 *
+		 * \param A0 Initial forward state metrics (size: d_S).
+		 * \param BK Final backward state metrics (size: d_S).
+		 * \param G Branch metrics (size: d_O*K).
+		 * \param out A posteriori branch log probabilities (will have a size
+		 *  of d_S*d_I*K at the end of function execution).
+		 */
+		void log_bcjr_recursions(const std::vector<float> &A0,
+				const std::vector<float> &BK,
+				const std::vector<float> &G,
+				std::vector<float> &out);
+
 	public:
 		/*! Constructs a log_bcjr_base object.
 		 * \param I The number of input sequences (e.g. 2 for binary codes).
@@ -86,6 +141,8 @@ class log_bcjr_base
 				const std::vector<int> &NS,
 				const std::vector<int> &OS);
 
+		virtual ~log_bcjr_base() {}
+
 		//! Computes max* of two value.
 		/*!
 		 * \param A First operand.
@@ -108,6 +165,54 @@ class log_bcjr_base
 		 */
 		virtual float _max_star(const float *vec, size_t n_ele) = 0;
 
+		/*! Converts log metrics to the representation expected by
+		 * forward_step(), backward_step() and app_step().
+		 *
+		 * Metrics are converted by blocks of n_ele elements (e.g. d_O for
+		 * branch metrics, d_S for state metrics). This implementation only
+		 * copies them.
+		 *
+		 * \param in Log metrics (size: n_ele*n_blocks).
+		 * \param out Converted metrics (size: n_ele*n_blocks).
+		 * \param n_ele Number of elements in a block.
+		 * \param n_blocks Number of blocks.
+		 */
+		virtual void prepare_metrics(const float *in, float *out, size_t n_ele,
+				size_t n_blocks);
+
+		//! Compute forward log metrics for a single time index.
+		/*!
+		 * Computes A_{k+1} from A_k, and normalizes it.
+		 *
+		 * \param G_k Log metrics at time index k (size: d_O).
+		 * \param A_prev Forward metrics at time index k (size: d_S).
+		 * \param A_curr Forward metrics at time index k+1 (size: d_S).
+		 */
+		virtual void forward_step(const float *G_k, const float *A_prev,
+				float *A_curr);
+
+		//! Compute backward log metrics for a single time index.
+		/*!
+		 * Computes B_k from B_{k+1}, and normalizes it.
+		 *
+		 * \param G_k Log metrics at time index k (size: d_O).
+		 * \param B_next Backward metrics at time index k+1 (size: d_S).
+		 * \param B_curr Backward metrics at time index k (size: d_S).
+		 */
+		virtual void backward_step(const float *G_k, const float *B_next,
+				float *B_curr);
+
+		//! Compute branch log a-posteriori probabilities for a single time index.
+		/*!
+		 * \param A_k Forward metrics at time index k (size: d_S).
+		 * \param B_next Backward metrics at time index k+1 (size: d_S).
+		 * \param G_k Log metrics at time index k (size: d_O).
+		 * \param out_k A posteriori branch log probabilities at time index k
+		 *  (size: d_S*d_I).
+		 */
+		virtual void app_step(const float *A_k, const float *B_next,
+				const float *G_k, float *out_k);
+
 		//! Compute forward log metrics.
 		/*!
 		 * From A_k(s) the forward log metric for state s at time index k, and
@@ -194,11 +299,88 @@ class log_bcjr_base
 		 *  to an additive constant (will have a size of d_S*d_I*K at the end of
 		 *  function execution).
 		 */
-		void log_bcjr_algorithm(const std::vector<float> &A0,
+		virtual void log_bcjr_algorithm(const std::vector<float> &A0,
 				const std::vector<float> &BK,
 				const std::vector<float> &in,
 				std::vector<float> &out);
 
+		/*! Computes logarithm of a-posteriori probabilities from the soft
+		 * inputs of a punctured code.
+		 *
+		 * Branch metrics of each trellis step are computed on the fly from
+		 * the soft inputs, skipping punctured positions, so that the d_O*K
+		 * metrics buffer is never built. Only the forward metrics are
+		 * stored (in the format selected by set_storage()): APPs are
+		 * computed along the backward recursion. This always uses the
+		 * serial schedule.
+		 *
+		 * \param A0 Log of initial state probabilities of the encoder (size: d_S).
+		 * \param BK Log of final state probabilities of the encoder (size: d_S).
+		 * \param llr Log-likelihood ratios of the transmitted bits (size:
+		 *  pattern.get_n_soft(K)).
+		 * \param pattern Puncturing pattern (d_O must be 2^pattern.get_n()).
+		 * \param K Number of trellis steps.
+		 * \param out A quantity equivalent to log a-posteriori probabilites, up
+		 *  to an additive constant (will have a size of d_S*d_I*K at the end of
+		 *  function execution).
+		 */
+		void log_bcjr_algorithm_punctured(const std::vector<float> &A0,
+				const std::vector<float> &BK,
+				const std::vector<float> &llr,
+				const puncturing_pattern &pattern, size_t K,
+				std::vector<float> &out);
+
+		/*! Computes symbol log-likelihood ratios from branch log
+		 * a-posteriori probabilities.
+		 *
+		 * For each time index k and input symbol i in [1 ; d_I[:
+		 * LLR_k(i) = max*_s APP_k(s,0) - max*_s APP_k(s,i),
+		 * which is the usual bit LLR for binary codes.
+		 *
+		 * \param app Branch log a-posteriori probabilities, as returned by
+		 *  log_bcjr_algorithm() (size: d_S*d_I*K).
+		 * \param llr Log-likelihood ratios (will have a size of (d_I-1)*K at
+		 *  the end of function execution).
+		 */
+		void compute_llr(const std::vector<float> &app, std::vector<float> &llr);
+
+		/*! Selects the schedule used by log_bcjr_algorithm().
+		 *
+		 * When enabled, the forward and backward recursions run concurrently
+		 * on two threads, which can roughly halve the latency of a single
+		 * block when two cores are available. Results are identical to the
+		 * serial schedule, and exceptions thrown on either thread are
+		 * propagated to the caller.
+		 *
+		 * \param bidirectional true to enable the concurrent schedule.
+		 */
+		void set_bidirectional(bool bidirectional) { d_bidirectional = bidirectional; }
+		//! Getter for d_bidirectional.
+		bool get_bidirectional() { return d_bidirectional; }
+
+		//! Selects the format in which forward metrics are stored.
+		/*!
+		 * Recursions still compute in single precision, but forward
+		 * metrics are rounded to a 16-bit format when stored for the APP
+		 * computation, and backward metrics are not stored at all. This
+		 * divides the memory footprint (and traffic) of stored state metrics
+		 * by 4, at the cost of a small loss of accuracy on APPs (see
+		 * examples/bcjr_storage_accuracy.py).
+		 *
+		 * The format applies to log_bcjr_algorithm() and
+		 * log_bcjr_algorithm_punctured(). With a format other than
+		 * METRIC_FLOAT32, log_bcjr_algorithm() always uses the serial
+		 * schedule.
+		 *
+		 * \param storage Storage format (default: METRIC_FLOAT32).
+		 */
+		virtual void set_storage(metric_storage storage) { d_storage = storage; }
+		//! Getter for d_storage.
+		metric_storage get_storage() { return d_storage; }
+
+		//! Getter for d_perf.
+		perf_counters& get_perf_counters() { return d_perf; }
+
 		//! Getter for d_I.
 		int get_I() { return d_I; }
 		//! Getter for d_S.
@@ -0,0 +1,139 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "log_bcjr_stream.h"
+
+log_bcjr_stream::log_bcjr_stream(log_bcjr_base &dec,
+		const std::vector<float> &A0, size_t lookahead, bool llr)
+	: d_dec(dec), d_I(dec.get_I()), d_S(dec.get_S()), d_O(dec.get_O()),
+	  d_lookahead(lookahead), d_llr(llr), d_B_uniform(d_S)
+{
+	std::vector<float> B_uniform(d_S, 0.0);
+	d_dec.prepare_metrics(&B_uniform[0], &d_B_uniform[0], d_S, 1);
+
+	reset(A0);
+}
+
+void
+log_bcjr_stream::reset(const std::vector<float> &A0)
+{
+	if (A0.size() != (size_t)d_S) {
+		throw std::runtime_error("Invalid size for A0.");
+	}
+
+	d_G.clear();
+	d_A.resize(d_S);
+	d_dec.prepare_metrics(&A0[0], &d_A[0], d_S, 1);
+}
+
+void
+log_bcjr_stream::push(const float *in, size_t K, std::vector<float> &out)
+{
+	size_t n_prev = get_pending();
+
+	PERF_ADD(d_dec.get_perf_counters(), PERF_CALLS, 1);
+	PERF_ADD(d_dec.get_perf_counters(), PERF_STEPS, K);
+
+	{
+		PERF_SCOPE(d_dec.get_perf_counters(), PERF_FW_METRICS);
+
+		d_G.resize(d_O*(n_prev+K));
+		d_A.resize(d_S*(n_prev+K+1));
+		d_dec.prepare_metrics(in, &d_G[d_O*n_prev], d_O, K);
+
+		//Forward recursion over the new time indexes
+		for(size_t k=n_prev ; k < n_prev+K ; ++k) {
+			d_dec.forward_step(&d_G[k*d_O], &d_A[k*d_S], &d_A[(k+1)*d_S]);
+		}
+	}
+
+	if (get_pending() > d_lookahead) {
+		emit(d_B_uniform, get_pending() - d_lookahead, out);
+	}
+}
+
+void
+log_bcjr_stream::flush(const std::vector<float> &BK,
+		const std::vector<float> &A0, std::vector<float> &out)
+{
+	std::vector<float> BK_dec(d_S);
+
+	if (BK.size() != (size_t)d_S) {
+		throw std::runtime_error("Invalid size for BK.");
+	}
+
+	d_dec.prepare_metrics(&BK[0], &BK_dec[0], d_S, 1);
+	emit(BK_dec, get_pending(), out);
+
+	reset(A0);
+}
+
+void
+log_bcjr_stream::emit(const std::vector<float> &BK, size_t n_emit,
+		std::vector<float> &out)
+{
+	size_t n_pending = get_pending();
+	std::vector<float> B_next(BK), B_curr(d_S);
+	std::vector<float> app(d_S*d_I*n_emit);
+
+	if (n_emit == 0) {
+		return;
+	}
+
+	PERF_ADD(d_dec.get_perf_counters(), PERF_BYTES_ALLOCATED,
+			(2*d_S + app.size())*sizeof(float));
+
+	//Backward recursion over the look-ahead
+	{
+		PERF_SCOPE(d_dec.get_perf_counters(), PERF_BW_METRICS);
+		for(size_t k=n_pending ; k > n_emit ; --k) {
+			d_dec.backward_step(&d_G[(k-1)*d_O], &B_next[0], &B_curr[0]);
+			B_next.swap(B_curr);
+		}
+	}
+
+	//Backward recursion over emitted time indexes, and APPs
+	{
+		PERF_SCOPE(d_dec.get_perf_counters(), PERF_FUSED_APP);
+		for(size_t k=n_emit ; k > 0 ; --k) {
+			d_dec.app_step(&d_A[(k-1)*d_S], &B_next[0], &d_G[(k-1)*d_O],
+					&app[(k-1)*d_S*d_I]);
+
+			if (k > 1) {
+				d_dec.backward_step(&d_G[(k-1)*d_O], &B_next[0], &B_curr[0]);
+				B_next.swap(B_curr);
+			}
+		}
+	}
+
+	if (d_llr) {
+		std::vector<float> llr;
+		d_dec.compute_llr(app, llr);
+		out.insert(out.end(), llr.begin(), llr.end());
+	}
+	else {
+		out.insert(out.end(), app.begin(), app.end());
+	}
+
+	//Forget emitted time indexes (forward metrics of the first pending one
+	//are kept)
+	d_G.erase(d_G.begin(), d_G.begin() + n_emit*d_O);
+	d_A.erase(d_A.begin(), d_A.begin() + n_emit*d_S);
+}
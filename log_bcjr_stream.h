@@ -0,0 +1,118 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_LOG_BCJR_STREAM_H
+#define INCLUDED_TURBO_LOG_BCJR_STREAM_H
+
+#include "log_bcjr_base.h"
+
+/*!
+* \brief Sliding-window BCJR for continuous streams of branch metrics.
+*
+* Branch metrics are pushed by chunks of any size. Forward metrics are carried
+* over from one chunk to the next, so that no block boundary is introduced in
+* the stream. APPs of a time index are emitted once lookahead more time
+* indexes have been received: backward recursions start from equiprobable
+* states lookahead steps ahead of the last emitted time index.
+*
+* The latency is thus fixed (lookahead time indexes), and memory is bounded
+* by the size of a chunk plus the lookahead.
+*/
+class log_bcjr_stream
+{
+	private:
+		//! The underlying decoder.
+		log_bcjr_base &d_dec;
+		//! The number of possible input sequences.
+		int d_I;
+		//! The number of states in the trellis.
+		int d_S;
+		//! The number of possible output sequences.
+		int d_O;
+		//! Number of time indexes between reception and emission of a branch.
+		size_t d_lookahead;
+		//! Whether LLRs are emitted instead of branch APPs.
+		bool d_llr;
+
+		//! Branch metrics of pending time indexes (size: d_O*n_pending).
+		std::vector<float> d_G;
+		//! Forward metrics of pending time indexes (size: d_S*(n_pending+1)).
+		std::vector<float> d_A;
+		//! Equiprobable backward metrics, used at the end of the look-ahead.
+		std::vector<float> d_B_uniform;
+
+		/*! Emits APPs (or LLRs) of the n_emit first pending time indexes.
+		 *
+		 * \param BK Backward metrics after the last pending time index
+		 *  (size: d_S).
+		 * \param n_emit Number of time indexes to emit.
+		 * \param out Output vector, to which APPs (or LLRs) are appended.
+		 */
+		void emit(const std::vector<float> &BK, size_t n_emit,
+				std::vector<float> &out);
+
+	public:
+		/*! Constructs a log_bcjr_stream object.
+		 *
+		 * \param dec Decoder used for the recursions (must outlive the
+		 *  stream).
+		 * \param A0 Log of initial state probabilities of the encoder (size: d_S).
+		 * \param lookahead Number of time indexes used by the backward
+		 *  recursion before emitting an APP.
+		 * \param llr If true, emit log-likelihood ratios (d_I-1 per time
+		 *  index, see log_bcjr_base::compute_llr()) instead of branch APPs
+		 *  (d_S*d_I per time index).
+		 */
+		log_bcjr_stream(log_bcjr_base &dec, const std::vector<float> &A0,
+				size_t lookahead, bool llr = false);
+
+		/*! Processes a chunk of branch metrics.
+		 *
+		 * \param in Log of input branch metrics (size: d_O*K).
+		 * \param K Number of time indexes in the chunk.
+		 * \param out Output vector, to which APPs (or LLRs) of the time
+		 *  indexes ready for emission are appended.
+		 */
+		void push(const float *in, size_t K, std::vector<float> &out);
+
+		/*! Emits every pending time index, and restarts the stream.
+		 *
+		 * \param BK Log of final state probabilities of the encoder (size: d_S).
+		 * \param A0 Log of initial state probabilities for the next stream
+		 *  (size: d_S).
+		 * \param out Output vector, to which APPs (or LLRs) are appended.
+		 */
+		void flush(const std::vector<float> &BK, const std::vector<float> &A0,
+				std::vector<float> &out);
+
+		/*! Drops every pending time index, and restarts the stream.
+		 *
+		 * \param A0 Log of initial state probabilities for the next stream
+		 *  (size: d_S).
+		 */
+		void reset(const std::vector<float> &A0);
+
+		//! Number of received time indexes not emitted yet.
+		size_t get_pending() { return d_G.size()/d_O; }
+		//! Getter for d_lookahead.
+		size_t get_lookahead() { return d_lookahead; }
+};
+
+#endif /* INCLUDED_TURBO_LOG_BCJR_STREAM_H */
@@ -0,0 +1,250 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "metric_storage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+//! Largest finite half precision float.
+static const float FLOAT16_MAX = 65504.0f;
+//! Largest finite bfloat16 (0x7F7F).
+static const float BFLOAT16_MAX = 3.38953139e38f;
+
+static inline uint32_t
+float_bits(float f)
+{
+	uint32_t x;
+	memcpy(&x, &f, sizeof(x));
+	return x;
+}
+
+static inline float
+bits_float(uint32_t x)
+{
+	float f;
+	memcpy(&f, &x, sizeof(f));
+	return f;
+}
+
+static inline uint16_t
+float_to_float16(float f)
+{
+	uint32_t x = float_bits(f);
+	uint16_t sign = (x >> 16) & 0x8000;
+	uint32_t abs_x = x & 0x7FFFFFFF;
+
+	//NaN
+	if (abs_x > 0x7F800000) {
+		return sign | 0x7E00;
+	}
+
+	//Rounds beyond the largest finite value (65520 and above)
+	if (abs_x >= 0x477FF000) {
+		return sign | 0x7BFF;
+	}
+
+	//Subnormal (or zero) half precision float
+	if (abs_x < 0x38800000) {
+		return sign | (uint16_t)nearbyintf(bits_float(abs_x)*16777216.0f);
+	}
+
+	//Round to nearest even, and rebias exponent (127 -> 15)
+	abs_x += 0xFFF + ((abs_x >> 13) & 1);
+	return sign | ((abs_x - 0x38000000) >> 13);
+}
+
+static inline float
+float16_to_float(uint16_t h)
+{
+	uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+	uint32_t exponent = (h >> 10) & 0x1F;
+	uint32_t mantissa = h & 0x3FF;
+
+	if (exponent == 0) {
+		float f = ldexpf((float)mantissa, -24);
+		return (sign) ? -f : f;
+	}
+
+	if (exponent == 31) {
+		return bits_float(sign | 0x7F800000 | (mantissa << 13));
+	}
+
+	return bits_float(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+static inline uint16_t
+float_to_bfloat16(float f)
+{
+	uint32_t x = float_bits(std::max(-BFLOAT16_MAX, std::min(f, BFLOAT16_MAX)));
+
+	//Round to nearest even
+	return (x + 0x7FFF + ((x >> 16) & 1)) >> 16;
+}
+
+static inline float
+bfloat16_to_float(uint16_t h)
+{
+	return bits_float((uint32_t)h << 16);
+}
+
+static inline uint16_t
+float_to_int16(float f)
+{
+	f = std::max(-32768.0f, std::min(f*METRIC_INT16_SCALE, 32767.0f));
+
+	return (uint16_t)(int16_t)lrintf(f);
+}
+
+static inline float
+int16_to_float(uint16_t h)
+{
+	return (float)(int16_t)h * (1.0f/METRIC_INT16_SCALE);
+}
+
+void
+pack_metrics(metric_storage fmt, const float *in, size_t n_ele, uint16_t *out)
+{
+	size_t n = 0;
+
+	switch (fmt) {
+		case METRIC_FLOAT16:
+#ifdef __F16C__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				__m128 x = _mm_loadu_ps(in + n);
+
+				x = _mm_max_ps(_mm_set1_ps(-FLOAT16_MAX),
+						_mm_min_ps(x, _mm_set1_ps(FLOAT16_MAX)));
+				_mm_storel_epi64((__m128i *)(out + n),
+						_mm_cvtps_ph(x, _MM_FROUND_TO_NEAREST_INT));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = float_to_float16(in[n]);
+			}
+			break;
+
+		case METRIC_BFLOAT16:
+#ifdef __SSE2__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				__m128 x = _mm_loadu_ps(in + n);
+				__m128i bits;
+
+				x = _mm_max_ps(_mm_set1_ps(-BFLOAT16_MAX),
+						_mm_min_ps(x, _mm_set1_ps(BFLOAT16_MAX)));
+				bits = _mm_castps_si128(x);
+
+				//Round to nearest even, and keep the 16 upper bits
+				//(sign-extended, so that packing does not saturate)
+				bits = _mm_add_epi32(bits, _mm_add_epi32(_mm_set1_epi32(0x7FFF),
+							_mm_and_si128(_mm_srli_epi32(bits, 16),
+								_mm_set1_epi32(1))));
+				bits = _mm_srai_epi32(bits, 16);
+				_mm_storel_epi64((__m128i *)(out + n),
+						_mm_packs_epi32(bits, bits));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = float_to_bfloat16(in[n]);
+			}
+			break;
+
+		case METRIC_INT16:
+#ifdef __SSE2__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				__m128 x = _mm_mul_ps(_mm_loadu_ps(in + n),
+						_mm_set1_ps(METRIC_INT16_SCALE));
+				__m128i q;
+
+				x = _mm_max_ps(_mm_set1_ps(-32768.0f),
+						_mm_min_ps(x, _mm_set1_ps(32767.0f)));
+				q = _mm_cvtps_epi32(x);
+				_mm_storel_epi64((__m128i *)(out + n), _mm_packs_epi32(q, q));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = float_to_int16(in[n]);
+			}
+			break;
+
+		default:
+			break;
+	}
+}
+
+void
+unpack_metrics(metric_storage fmt, const uint16_t *in, size_t n_ele, float *out)
+{
+	size_t n = 0;
+
+	switch (fmt) {
+		case METRIC_FLOAT16:
+#ifdef __F16C__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				_mm_storeu_ps(out + n,
+						_mm_cvtph_ps(_mm_loadl_epi64((const __m128i *)(in + n))));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = float16_to_float(in[n]);
+			}
+			break;
+
+		case METRIC_BFLOAT16:
+#ifdef __SSE2__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				__m128i h = _mm_loadl_epi64((const __m128i *)(in + n));
+
+				_mm_storeu_ps(out + n, _mm_castsi128_ps(
+							_mm_unpacklo_epi16(_mm_setzero_si128(), h)));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = bfloat16_to_float(in[n]);
+			}
+			break;
+
+		case METRIC_INT16:
+#ifdef __SSE2__
+			for( ; n + 4 <= n_ele ; n += 4) {
+				__m128i h = _mm_loadl_epi64((const __m128i *)(in + n));
+				__m128i q = _mm_srai_epi32(_mm_unpacklo_epi16(h, h), 16);
+
+				_mm_storeu_ps(out + n, _mm_mul_ps(_mm_cvtepi32_ps(q),
+							_mm_set1_ps(1.0f/METRIC_INT16_SCALE)));
+			}
+#endif
+			for( ; n < n_ele ; ++n) {
+				out[n] = int16_to_float(in[n]);
+			}
+			break;
+
+		default:
+			break;
+	}
+}
@@ -0,0 +1,73 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_METRIC_STORAGE_H
+#define INCLUDED_TURBO_METRIC_STORAGE_H
+
+#include <cstddef>
+#include <cstdint>
+
+/*!
+* \brief Formats in which state metrics can be stored between recursions.
+*
+* Recursions always compute in single precision, only the stored copy of
+* the metrics is rounded.
+*/
+enum metric_storage
+{
+	//! Single precision float (no rounding).
+	METRIC_FLOAT32 = 0,
+	//! IEEE 754 half precision float (11-bit significand, saturates at
+	//! +/-65504).
+	METRIC_FLOAT16,
+	//! bfloat16 (8-bit significand, same range as single precision).
+	METRIC_BFLOAT16,
+	//! 16-bit fixed point with METRIC_INT16_SCALE steps per unit (saturates
+	//! at +/-32768/METRIC_INT16_SCALE).
+	METRIC_INT16
+};
+
+//! Number of METRIC_INT16 steps per unit (resolution of 1/256 nat).
+const float METRIC_INT16_SCALE = 256.0f;
+
+/*! Converts single precision metrics to a 16-bit storage format.
+ *
+ * Values are rounded to the nearest representable value, and saturate to
+ * the largest finite one.
+ *
+ * \param fmt Storage format (METRIC_FLOAT32 is not a 16-bit format).
+ * \param in Input metrics (size: n_ele).
+ * \param n_ele Number of metrics.
+ * \param out Stored metrics (size: n_ele).
+ */
+void pack_metrics(metric_storage fmt, const float *in, size_t n_ele,
+		uint16_t *out);
+
+/*! Converts metrics stored by pack_metrics() back to single precision.
+ *
+ * \param fmt Storage format used by pack_metrics().
+ * \param in Stored metrics (size: n_ele).
+ * \param n_ele Number of metrics.
+ * \param out Output metrics (size: n_ele).
+ */
+void unpack_metrics(metric_storage fmt, const uint16_t *in, size_t n_ele,
+		float *out);
+
+#endif /* INCLUDED_TURBO_METRIC_STORAGE_H */
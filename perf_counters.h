@@ -0,0 +1,174 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_PERF_COUNTERS_H
+#define INCLUDED_TURBO_PERF_COUNTERS_H
+
+#include <atomic>
+#include <cstdint>
+
+#ifdef PYTURBO_PERF_COUNTERS
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <chrono>
+#endif
+#endif
+
+//! Counters of a perf_counters object.
+enum perf_counter {
+	PERF_FW_METRICS = 0,	//!< Cycles spent in forward recursions.
+	PERF_BW_METRICS,		//!< Cycles spent in backward recursions.
+	PERF_APP,				//!< Cycles spent computing APPs.
+	PERF_FUSED_APP,			//!< Cycles spent in loops computing APPs along with
+							//!< a recursion (timed as a whole).
+	PERF_ACS,				//!< Cycles spent in Viterbi add-compare-select.
+	PERF_TRACEBACK,			//!< Cycles spent in Viterbi traceback.
+	PERF_BINDING,			//!< Cycles spent converting data in the Python bindings.
+	PERF_STEPS,				//!< Trellis steps processed.
+	PERF_BYTES_ALLOCATED,	//!< Bytes allocated for working buffers.
+	PERF_CALLS,				//!< Decoding calls served.
+	PERF_N_COUNTERS
+};
+
+//! Reads the cycle counter (TSC ticks on x86, nanoseconds elsewhere).
+/*!
+ * Returns 0 if performance counters are disabled.
+ */
+static inline uint64_t perf_clock()
+{
+#ifdef PYTURBO_PERF_COUNTERS
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+#else
+	return 0;
+#endif
+}
+
+//! Whether PyTurbo is compiled with performance counters.
+static inline bool perf_counters_enabled()
+{
+#ifdef PYTURBO_PERF_COUNTERS
+	return true;
+#else
+	return false;
+#endif
+}
+
+/*!
+* \brief Performance counters of a decoder.
+*
+* Counters are only updated if PyTurbo is compiled with PYTURBO_PERF_COUNTERS
+* defined: otherwise, the PERF_* macros below compile to nothing, and every
+* counter reads 0. Counters can be updated concurrently (e.g. by the two
+* threads of the bidirectional BCJR).
+*/
+class perf_counters
+{
+	private:
+		std::atomic<uint64_t> d_counters[PERF_N_COUNTERS];
+
+	public:
+		perf_counters() { reset(); }
+
+		//! Adds n to a counter.
+		void add(int counter, uint64_t n)
+		{
+			d_counters[counter].fetch_add(n, std::memory_order_relaxed);
+		}
+
+		//! Reads a counter.
+		uint64_t get(int counter) const
+		{
+			return d_counters[counter].load(std::memory_order_relaxed);
+		}
+
+		//! Sets every counter to 0.
+		void reset()
+		{
+			for(int c=0 ; c < PERF_N_COUNTERS ; ++c) {
+				d_counters[c].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		//! Name of a counter.
+		static const char *name(int counter)
+		{
+			static const char *names[PERF_N_COUNTERS] = {"fw_metrics",
+				"bw_metrics", "app", "fused_app", "acs", "traceback", "binding",
+				"steps", "bytes_allocated", "calls"};
+
+			return names[counter];
+		}
+};
+
+//! Adds the cycles elapsed since start (read with perf_clock()) to a counter.
+/*!
+ * Does nothing if performance counters are disabled.
+ */
+static inline void perf_elapsed(perf_counters &perf, int counter, uint64_t start)
+{
+#ifdef PYTURBO_PERF_COUNTERS
+	perf.add(counter, perf_clock() - start);
+#else
+	(void)perf;
+	(void)counter;
+	(void)start;
+#endif
+}
+
+/*!
+* \brief Adds the cycles elapsed during its lifetime to a counter.
+*/
+class perf_scope
+{
+	private:
+		perf_counters &d_perf;
+		int d_counter;
+		uint64_t d_start;
+
+	public:
+		perf_scope(perf_counters &perf, int counter)
+			: d_perf(perf), d_counter(counter), d_start(perf_clock()) {}
+
+		~perf_scope() { d_perf.add(d_counter, perf_clock() - d_start); }
+};
+
+#ifdef PYTURBO_PERF_COUNTERS
+//! Times the rest of the enclosing scope.
+#define PERF_SCOPE(perf, counter) perf_scope perf_scope_##counter((perf), (counter))
+//! Adds n to a counter.
+#define PERF_ADD(perf, counter, n) (perf).add((counter), (n))
+//! Declares a variable holding the current cycle count.
+#define PERF_TIMESTAMP(var) uint64_t var = perf_clock()
+//! Adds the cycles elapsed since PERF_TIMESTAMP(var) to a counter.
+#define PERF_ELAPSED(perf, counter, var) (perf).add((counter), perf_clock() - (var))
+#else
+#define PERF_SCOPE(perf, counter) do {} while(0)
+#define PERF_ADD(perf, counter, n) do {} while(0)
+#define PERF_TIMESTAMP(var) do {} while(0)
+#define PERF_ELAPSED(perf, counter, var) do {} while(0)
+#endif
+
+#endif /* INCLUDED_TURBO_PERF_COUNTERS_H */
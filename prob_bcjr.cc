@@ -0,0 +1,202 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "prob_bcjr.h"
+
+//! Log APP of pruned branches: log(DBL_MIN), below the log APP of any branch
+//! whose probability did not underflow (about -310 at worst).
+static const float PROB_BCJR_LOG_APP_FLOOR = log(std::numeric_limits<double>::min());
+
+void
+prob_bcjr::generate_tables()
+{
+	d_fanin = d_PS[0].size();
+
+	for(int s=1 ; s < d_S ; ++s) {
+		if((int)d_PS[s].size() != d_fanin) {
+			d_fanin = 0;
+			break;
+		}
+	}
+
+	if (d_fanin > 0) {
+		d_fw_PS.resize(d_fanin*d_S);
+		d_fw_OS.resize(d_fanin*d_S);
+
+		for(int s=0 ; s < d_S ; ++s) {
+			for(int j=0 ; j < d_fanin ; ++j) {
+				d_fw_PS[j*d_S + s] = d_PS[s][j];
+				d_fw_OS[j*d_S + s] = d_ordered_OS[s*d_fanin + j];
+			}
+		}
+	}
+
+	d_bw_NS.resize(d_I*d_S);
+	d_bw_OS.resize(d_I*d_S);
+
+	for(int s=0 ; s < d_S ; ++s) {
+		for(int i=0 ; i < d_I ; ++i) {
+			d_bw_NS[i*d_S + s] = d_NS[s*d_I + i];
+			d_bw_OS[i*d_S + s] = d_OS[s*d_I + i];
+		}
+	}
+}
+
+void
+prob_bcjr::prepare_metrics(const float *in, float *out, size_t n_ele,
+		size_t n_blocks)
+{
+	for(size_t k=0 ; k < n_ele*n_blocks ; k += n_ele) {
+		float max_val = *std::max_element(in + k, in + k + n_ele);
+
+		//Every element is -inf: exp(in - max_val) would be NaN
+		if (max_val == -std::numeric_limits<float>::infinity()) {
+			std::fill(out + k, out + k + n_ele, 1.0);
+			continue;
+		}
+
+		for(size_t j=k ; j < k + n_ele ; ++j) {
+			out[j] = exp(in[j] - max_val);
+		}
+	}
+}
+
+/*!
+ * Computes out[s] = sum_j M[idx_M[j*S+s]] * G[idx_G[j*S+s]] (j in
+ * [0 ; n_terms[), and scales out so that it sums to one.
+ *
+ * Inner loops run over the contiguous rows of the transposed tables, so that
+ * they vectorize (with gathered loads of M and G).
+ */
+static inline void
+prob_bcjr_multiply_add(const float *M, const float *G, const int *idx_M,
+		const int *idx_G, int n_terms, int S, float *out)
+{
+	float norm = 0.0;
+
+	for(int s=0 ; s < S ; ++s) {
+		out[s] = M[idx_M[s]] * G[idx_G[s]];
+	}
+
+	for(int j=1 ; j < n_terms ; ++j) {
+		const int *idx_M_j = idx_M + j*S;
+		const int *idx_G_j = idx_G + j*S;
+
+		for(int s=0 ; s < S ; ++s) {
+			out[s] += M[idx_M_j[s]] * G[idx_G_j[s]];
+		}
+	}
+
+	for(int s=0 ; s < S ; ++s) {
+		norm += out[s];
+	}
+
+	//Metrics normalization
+	if (norm > 0.0) {
+		norm = 1.0/norm;
+		for(int s=0 ; s < S ; ++s) {
+			out[s] *= norm;
+		}
+	}
+}
+
+void
+prob_bcjr::forward_step(const float *G_k, const float *A_prev, float *A_curr)
+{
+	//Non-uniform fan-in: sum over the branches of each state
+	if (d_fanin == 0) {
+		std::vector<int>::const_iterator PS_it;
+		std::vector<int>::const_iterator ordered_OS_it = d_ordered_OS.begin();
+		float norm_A = 0.0;
+
+		for(int s=0 ; s < d_S ; ++s) {
+			PS_it=d_PS[s].begin();
+
+			A_curr[s] = 0.0;
+			for(size_t i=0 ; i<(d_PS[s]).size() ; ++i) {
+				A_curr[s] += A_prev[*(PS_it++)] * G_k[*(ordered_OS_it++)];
+			}
+
+			norm_A += A_curr[s];
+		}
+
+		//Metrics normalization
+		if (norm_A > 0.0) {
+			norm_A = 1.0/norm_A;
+			for(int s=0 ; s < d_S ; ++s) {
+				A_curr[s] *= norm_A;
+			}
+		}
+
+		return;
+	}
+
+	prob_bcjr_multiply_add(A_prev, G_k, &d_fw_PS[0], &d_fw_OS[0], d_fanin,
+			d_S, A_curr);
+}
+
+void
+prob_bcjr::backward_step(const float *G_k, const float *B_next, float *B_curr)
+{
+	prob_bcjr_multiply_add(B_next, G_k, &d_bw_NS[0], &d_bw_OS[0], d_I, d_S,
+			B_curr);
+}
+
+void
+prob_bcjr::app_step(const float *A_k, const float *B_next, const float *G_k,
+		float *out_k)
+{
+	for(int s=0 ; s < d_S ; ++s) {
+		for (int i=0 ; i < d_I ; ++i) {
+			//Product in double precision, so that it cannot underflow
+			double app = (double)B_next[d_NS[s*d_I+i]] * G_k[d_OS[s*d_I+i]] * A_k[s];
+
+			*(out_k++) = (app > 0.0) ? (float)log(app)
+				: PROB_BCJR_LOG_APP_FLOOR;
+		}
+	}
+}
+
+void
+prob_bcjr::log_bcjr_algorithm(const std::vector<float> &A0,
+		const std::vector<float> &BK, const std::vector<float> &in,
+		std::vector<float> &out)
+{
+	std::vector<float> A0_lin(d_S), BK_lin(d_S), G(in.size());
+
+	PERF_ADD(d_perf, PERF_BYTES_ALLOCATED, (2*d_S + in.size())*sizeof(float));
+
+	//Exponentiate metrics once
+	prepare_metrics(&A0[0], &A0_lin[0], d_S, 1);
+	prepare_metrics(&BK[0], &BK_lin[0], d_S, 1);
+	prepare_metrics(in.data(), G.data(), d_O, in.size()/d_O);
+
+	log_bcjr_recursions(A0_lin, BK_lin, G, out);
+}
+
+void
+prob_bcjr::set_storage(metric_storage storage)
+{
+	if ((storage != METRIC_FLOAT32) && (storage != METRIC_BFLOAT16)) {
+		throw std::runtime_error("Unsupported storage format for prob_bcjr.");
+	}
+
+	d_storage = storage;
+}
@@ -0,0 +1,148 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_PROB_BCJR_H
+#define INCLUDED_TURBO_PROB_BCJR_H
+
+#include "log_bcjr.h"
+
+/*!
+* \brief BCJR algorithm in the probability domain, with per-step scaling.
+*
+* Takes the same log branch metrics as log_bcjr, and returns the same log
+* a-posteriori probabilities (up to an additive constant). Branch metrics are
+* exponentiated once per symbol, after which the forward and backward
+* recursions only use multiply-adds. Forward and backward metrics are scaled
+* to sum to one at every time index, which prevents underflow.
+*
+* Results match log_bcjr as long as the log metrics of the branches (and
+* states) that matter stay within the dynamic range of single precision
+* floats (about 87 nats) of the best one at each time index. Beyond that,
+* very unlikely branches are pruned: their log APP is set to log(DBL_MIN)
+* (about -708), so that LLRs stay finite, and saturate at about 708 nats
+* (plus log(S)) instead of growing with the reliability of the decision.
+*
+* Note: compute_fw_metrics(), compute_bw_metrics() and compute_app() take
+* linear-domain (not log) branch and state metrics for this class.
+*/
+class prob_bcjr : public log_bcjr_base
+{
+	private:
+		/* Number of branches reaching each state when it is the same for
+		 * every state (uniform fan-in), 0 otherwise.
+		 */
+		int d_fanin;
+		/* Previous states and ordered output symbols, transposed:
+		 * d_fw_PS[j*S+s] = PS[s][j] and
+		 * d_fw_OS[j*S+s] = ordered_OS[s*d_fanin+j] (only valid if
+		 * d_fanin != 0).
+		 */
+		std::vector<int> d_fw_PS;
+		std::vector<int> d_fw_OS;
+		/* Next states and output symbols, transposed:
+		 * d_bw_NS[i*S+s] = NS[s*I+i] and d_bw_OS[i*S+s] = OS[s*I+i].
+		 */
+		std::vector<int> d_bw_NS;
+		std::vector<int> d_bw_OS;
+
+		//! Generates the transposed tables.
+		void generate_tables();
+
+	public:
+		//! Default constructor.
+		prob_bcjr();
+
+		/*! Constructs a prob_bcjr object.
+		 * \param I The number of input sequences (e.g. 2 for binary codes).
+		 * \param S The number of states in the trellis.
+		 * \param O The number of output sequences (e.g. 4 for a binary code
+		 *  with a coding efficiency of 1/2).
+		 * \param NS Gives the next state ns of a branch defined by its
+		 *  initial state s and its input symbol i : NS[s*I+i]=ns.
+		 * \param OS Gives the output symbol os of a branch defined by its
+		 *  initial state s and its input symbol i : OS[s*I+i]=os.
+		 */
+		prob_bcjr(int I, int S, int O,
+				const std::vector<int> &NS,
+				const std::vector<int> &OS) : log_bcjr_base(I, S, O, NS, OS)
+		{
+			generate_tables();
+		}
+
+		// Override log_bcjr_base method
+		float _max_star(float A, float B) { return log_bcjr::max_star(A, B); }
+		// Override log_bcjr_base method
+		float _max_star(const float *vec, size_t n_ele) { return log_bcjr::max_star(vec, n_ele); }
+
+		//! Converts log metrics to linear metrics.
+		/*!
+		 * Each block of n_ele elements is exponentiated after being shifted
+		 * so that its maximum is 0. A block where every element is -inf
+		 * (impossible observation) carries no information, and yields
+		 * uniform metrics.
+		 */
+		void prepare_metrics(const float *in, float *out, size_t n_ele,
+				size_t n_blocks);
+
+		//! Compute forward metrics for a single time index.
+		/*!
+		 * A_{k+1}(s) = sum_{ s', i \in \tau(s',s) } G_k(s', i) * A_k(s'),
+		 * then A_{k+1} is scaled so that it sums to one.
+		 */
+		void forward_step(const float *G_k, const float *A_prev, float *A_curr);
+
+		//! Compute backward metrics for a single time index.
+		/*!
+		 * B_k(s) = sum_{ s', i \in \tau(s,s') } G_k(s, i) * B_{k+1}(s'),
+		 * then B_k is scaled so that it sums to one.
+		 */
+		void backward_step(const float *G_k, const float *B_next, float *B_curr);
+
+		//! Compute branch log a-posteriori probabilities for a single time index.
+		/*!
+		 * APP_k(s,i) = log(B_{k+1}(NS(s,i)) * G_k(s,i) * A_k(s)).
+		 */
+		void app_step(const float *A_k, const float *B_next, const float *G_k,
+				float *out_k);
+
+		/*! Actually computes logarithm of a-posteriori probabilities for a
+		 * given observation sequence.
+		 *
+		 * \param A0 Log of initial state probabilities of the encoder (size: d_S).
+		 * \param BK Log of final state probabilities of the encoder (size: d_S).
+		 * \param in Log of input branch metrics for the algorithm (size: d_O*k).
+		 * \param out A quantity equivalent to log a-posteriori probabilites, up
+		 *  to an additive constant (will have a size of d_S*d_I*K at the end of
+		 *  function execution).
+		 */
+		void log_bcjr_algorithm(const std::vector<float> &A0,
+				const std::vector<float> &BK,
+				const std::vector<float> &in,
+				std::vector<float> &out);
+
+		//! Selects the format in which forward metrics are stored.
+		/*!
+		 * Only METRIC_FLOAT32 and METRIC_BFLOAT16 are accepted: linear
+		 * metrics need the exponent range of single precision.
+		 */
+		void set_storage(metric_storage storage);
+};
+
+#endif /* INCLUDED_TURBO_PROB_BCJR_H */
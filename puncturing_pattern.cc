@@ -0,0 +1,68 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "puncturing_pattern.h"
+
+puncturing_pattern::puncturing_pattern(int n, const std::vector<int> &pattern)
+	: d_n(n), d_pattern(pattern)
+{
+	if (n <= 0 || pattern.empty() || pattern.size() % n != 0) {
+		throw std::runtime_error("Invalid size for pattern.");
+	}
+
+	d_period = pattern.size()/n;
+
+	d_offset.resize(d_period+1, 0);
+	for(size_t t=0 ; t < d_period ; ++t) {
+		d_offset[t+1] = d_offset[t];
+		for(int j=0 ; j < d_n ; ++j) {
+			if (d_pattern[t*d_n + j]) {
+				++d_offset[t+1];
+			}
+		}
+	}
+
+	if (d_offset[d_period] == 0) {
+		throw std::runtime_error("Pattern must transmit at least one bit.");
+	}
+}
+
+void
+puncturing_pattern::branch_metrics(const float *llr, size_t k, float *G_k,
+		float scale) const
+{
+	const int *pattern_k = &d_pattern[(k%d_period)*d_n];
+	const float *llr_k = llr + soft_offset(k);
+	size_t n_out = 1;
+
+	//Metrics are built one coded bit at a time: after bit j, G_k[o]
+	//holds the metric of the first j+1 bits of the codeword o.
+	G_k[0] = 0.0;
+	for(int j=0 ; j < d_n ; ++j) {
+		float half_llr = pattern_k[j] ? 0.5*scale*(*(llr_k++)) : 0.0;
+
+		for(size_t o=n_out ; o > 0 ; --o) {
+			G_k[2*o-1] = G_k[o-1] - half_llr;
+			G_k[2*o-2] = G_k[o-1] + half_llr;
+		}
+
+		n_out *= 2;
+	}
+}
@@ -0,0 +1,114 @@
+/* -*- c++ -*- */
+/*
+ * Copyright 2020 Alexandre Marquet.
+ *
+ * This is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 3, or (at your option)
+ * any later version.
+ *
+ * This software is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this software; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef INCLUDED_TURBO_PUNCTURING_PATTERN_H
+#define INCLUDED_TURBO_PUNCTURING_PATTERN_H
+
+#include <vector>
+#include <stdexcept>
+#include <cstddef>
+
+/*!
+* \brief Puncturing pattern of a code with n coded bits per trellis branch.
+*
+* The pattern covers a period of P trellis steps: pattern[t*n+j] is 1 if the
+* j-th coded bit of step t (modulo P) is transmitted, 0 if it is punctured.
+*
+* Soft inputs are given as one log-likelihood ratio log(P(b=0)/P(b=1)) per
+* transmitted bit, in transmission order. Coded bits b_0, ..., b_{n-1} of a
+* branch map to the output symbol o = b_0*2^(n-1) + ... + b_{n-1} of the
+* trellis (so O must be 2^n).
+*
+* branch_metrics() computes the metrics of a single trellis step directly
+* from the soft inputs, which lets decoders skip punctured positions without
+* building the depunctured d_O*K metrics buffer.
+*/
+class puncturing_pattern
+{
+	private:
+		//! Number of coded bits per trellis branch.
+		int d_n;
+		//! Period of the pattern, in trellis steps.
+		size_t d_period;
+		//! The pattern (size: d_period*d_n).
+		std::vector<int> d_pattern;
+		//! d_offset[t] is the number of transmitted bits in steps [0 ; t[ of a period.
+		std::vector<size_t> d_offset;
+
+	public:
+		/*! Constructs a puncturing_pattern object.
+		 *
+		 * \param n Number of coded bits per trellis branch.
+		 * \param pattern 1 for transmitted bits, 0 for punctured bits (size:
+		 *  multiple of n).
+		 */
+		puncturing_pattern(int n, const std::vector<int> &pattern);
+
+		//! Index of the first soft input of trellis step k.
+		size_t soft_offset(size_t k) const
+		{
+			return (k/d_period)*d_offset[d_period] + d_offset[k%d_period];
+		}
+
+		//! Number of soft inputs for K trellis steps.
+		size_t get_n_soft(size_t K) const { return soft_offset(K); }
+
+		//! Computes branch metrics of a single trellis step.
+		/*!
+		 * G_k(o) = scale * sum_{j transmitted} (b_j(o) ? -LLR_j : LLR_j)/2
+		 *
+		 * With scale = 1, these are log-BCJR branch metrics. With scale = -1,
+		 * these are Viterbi branch metrics (to be minimized).
+		 *
+		 * \param llr Soft inputs of the whole block.
+		 * \param k Trellis step.
+		 * \param G_k Branch metrics of step k (size: 2^n).
+		 * \param scale Scaling of the metrics.
+		 */
+		void branch_metrics(const float *llr, size_t k, float *G_k,
+				float scale) const;
+
+		/*! Puncture a sequence of coded bits (or of any per-bit data).
+		 *
+		 * \param in Coded sequence (size: n*K).
+		 * \param K Number of trellis steps.
+		 * \param out Transmitted elements of in (size: get_n_soft(K)).
+		 */
+		template<typename T>
+		void puncture(const T *in, size_t K, T *out) const
+		{
+			for(size_t k=0 ; k < K ; ++k) {
+				const int *pattern_k = &d_pattern[(k%d_period)*d_n];
+
+				for(int j=0 ; j < d_n ; ++j) {
+					if (pattern_k[j]) {
+						*(out++) = in[k*d_n + j];
+					}
+				}
+			}
+		}
+
+		//! Getter for d_n.
+		int get_n() const { return d_n; }
+		//! Getter for d_period.
+		size_t get_period() const { return d_period; }
+};
+
+#endif /* INCLUDED_TURBO_PUNCTURING_PATTERN_H */
@@ -1,7 +1,16 @@
+import os
+
 from distutils.core import setup
+from distutils.extension import Extension
 from Cython.Build import cythonize
 
+#Performance counters are compiled in if PYTURBO_PERF_COUNTERS is set
+define_macros = []
+if os.environ.get('PYTURBO_PERF_COUNTERS'):
+    define_macros.append(('PYTURBO_PERF_COUNTERS', None))
+
 setup(
     name="PyTurbo",
-    ext_modules = cythonize("PyTurbo.pyx"),
+    ext_modules = cythonize([Extension("PyTurbo", ["PyTurbo.pyx"],
+        define_macros=define_macros)]),
 )
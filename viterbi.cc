@@ -20,10 +20,41 @@
 
 #include "viterbi.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//! Branch metrics of a block, as given to viterbi_algorithm().
+struct block_metrics
+{
+	const float *in;
+	int O;
+
+	const float *operator()(int k) { return in + k*O; }
+};
+
+//! Branch metrics computed on the fly from the soft inputs of a punctured code.
+struct punctured_metrics
+{
+	const float *llr;
+	const puncturing_pattern &pattern;
+	std::vector<float> G_k;
+
+	punctured_metrics(const float *llr, const puncturing_pattern &pattern)
+		: llr(llr), pattern(pattern), G_k(1 << pattern.get_n()) {}
+
+	const float *operator()(int k)
+	{
+		pattern.branch_metrics(llr, k, &G_k[0], -1.0);
+		return &G_k[0];
+	}
+};
+
 viterbi::viterbi(int I, int S, int O,
 		const std::vector<int> &NS,
 		const std::vector<int> &OS)
-	: d_I(I), d_S(S), d_O(O), d_ordered_OS(S*I)
+	: d_I(I), d_S(S), d_O(O), d_ordered_OS(S*I),
+	  d_vectorized(true)
 {
 	if (NS.size() != S*I) {
 		throw std::runtime_error("Invalid size for NS.");
@@ -45,6 +76,8 @@ viterbi::viterbi(int I, int S, int O,
 			*(ordered_OS_it++) = OS[d_PS[s][i]*I + d_PI[s][i]];
 		}
 	}
+
+	generate_acs_tables();
 }
 
 void
@@ -70,11 +103,228 @@ viterbi::generate_PS_PI()
 	}
 }
 
+void
+viterbi::generate_acs_tables()
+{
+	d_fanin = d_PS[0].size();
+
+	for(int s=1 ; s<d_S ; ++s) {
+		if((int)d_PS[s].size() != d_fanin) {
+			d_fanin = 0;
+			return;
+		}
+	}
+
+	//With a single branch per state there is no decision to store: leave
+	//such trellises to the generic implementation
+	if(d_fanin < 2) {
+		d_fanin = 0;
+		return;
+	}
+
+	d_acs_PS.resize(d_fanin*d_S);
+	d_acs_OS.resize(d_fanin*d_S);
+
+	for(int s=0 ; s<d_S ; ++s) {
+		for(int j=0 ; j<d_fanin ; ++j) {
+			d_acs_PS[j*d_S + s] = d_PS[s][j];
+			d_acs_OS[j*d_S + s] = d_ordered_OS[s*d_fanin + j];
+		}
+	}
+}
+
 void
 viterbi::viterbi_algorithm(int K, int S0, int SK, const float *in,
 		unsigned int *out)
 {
-	viterbi_algorithm(d_I, d_S, d_O, d_NS, d_ordered_OS, d_PS, d_PI, K, S0, SK, in, out);
+	if(d_vectorized && d_fanin > 0) {
+		block_metrics metrics = {in, d_O};
+		viterbi_algorithm_acs(K, S0, SK, metrics, out);
+	}
+	else {
+		PERF_SCOPE(d_perf, PERF_ACS);
+		PERF_ADD(d_perf, PERF_CALLS, 1);
+		PERF_ADD(d_perf, PERF_STEPS, K);
+		PERF_ADD(d_perf, PERF_BYTES_ALLOCATED,
+				K*d_S*sizeof(int) + 2*d_S*sizeof(float));
+
+		viterbi_algorithm(d_I, d_S, d_O, d_NS, d_ordered_OS, d_PS, d_PI, K, S0,
+				SK, in, out);
+	}
+}
+
+void
+viterbi::viterbi_algorithm_punctured(int K, int S0, int SK, const float *llr,
+		const puncturing_pattern &pattern, unsigned int *out)
+{
+	if((1 << pattern.get_n()) != d_O) {
+		throw std::runtime_error("Invalid puncturing pattern for this trellis.");
+	}
+
+	if(d_vectorized && d_fanin > 0) {
+		punctured_metrics metrics(llr, pattern);
+		viterbi_algorithm_acs(K, S0, SK, metrics, out);
+	}
+	else {
+		//Depuncture the whole block for the generic implementation
+		std::vector<float> in(K*d_O);
+
+		PERF_SCOPE(d_perf, PERF_ACS);
+		PERF_ADD(d_perf, PERF_CALLS, 1);
+		PERF_ADD(d_perf, PERF_STEPS, K);
+		PERF_ADD(d_perf, PERF_BYTES_ALLOCATED,
+				K*d_O*sizeof(float) + K*d_S*sizeof(int) + 2*d_S*sizeof(float));
+		for(int k=0 ; k < K ; ++k) {
+			pattern.branch_metrics(llr, k, &in[k*d_O], -1.0);
+		}
+
+		viterbi_algorithm(d_I, d_S, d_O, d_NS, d_ordered_OS, d_PS, d_PI, K, S0,
+				SK, &in[0], out);
+	}
+}
+
+template<class METRICS>
+void
+viterbi::viterbi_algorithm_acs(int K, int S0, int SK, METRICS &metrics,
+		unsigned int *out)
+{
+	const int S = d_S;
+	const int F = d_fanin;
+
+	//Decisions are stored as bit-planes of the selected branch index
+	int n_planes = 0;
+	while((1 << n_planes) < F) {
+		++n_planes;
+	}
+	const int n_words = (S+31)/32;
+	const int trace_stride = n_planes*n_words;
+
+	int tb_state, pidx;
+	float min_metric;
+
+	std::vector<uint32_t> trace(K*trace_stride, 0);
+	std::vector<float> cand(F*S);
+	std::vector<float> alpha_prev(S, std::numeric_limits<float>::max());
+	std::vector<float> alpha_curr(S, std::numeric_limits<float>::max());
+
+	PERF_ADD(d_perf, PERF_CALLS, 1);
+	PERF_ADD(d_perf, PERF_STEPS, K);
+	PERF_ADD(d_perf, PERF_BYTES_ALLOCATED,
+			K*trace_stride*sizeof(uint32_t) + (F+2)*S*sizeof(float));
+
+	//If initial state was specified
+	if(S0 != -1) {
+		alpha_prev[S0] = 0.0;
+	}
+	else {
+		std::fill(alpha_prev.begin(), alpha_prev.end(), 0.0);
+	}
+
+	PERF_TIMESTAMP(acs_start);
+	for(int k=0 ; k < K ; ++k) {
+		const float *in_k = metrics(k);
+		uint32_t *trace_k = &trace[k*trace_stride];
+		int s = 0;
+
+		//ADD (gather candidates of every branch)
+		for(int j=0 ; j < F*S ; ++j) {
+			cand[j] = alpha_prev[d_acs_PS[j]] + in_k[d_acs_OS[j]];
+		}
+
+		min_metric = std::numeric_limits<float>::max();
+
+#ifdef __SSE2__
+		__m128 min_v = _mm_set1_ps(std::numeric_limits<float>::max());
+
+		for( ; s+4 <= S ; s += 4) {
+			__m128 best = _mm_loadu_ps(&cand[s]);
+			__m128i dec = _mm_setzero_si128();
+
+			for(int j=1 ; j < F ; ++j) {
+				//COMPARE
+				__m128 can_metric = _mm_loadu_ps(&cand[j*S + s]);
+				__m128 mask = _mm_cmplt_ps(can_metric, best);
+
+				//SELECT
+				best = _mm_or_ps(_mm_and_ps(mask, can_metric),
+						_mm_andnot_ps(mask, best));
+				dec = _mm_or_si128(
+						_mm_and_si128(_mm_castps_si128(mask), _mm_set1_epi32(j)),
+						_mm_andnot_si128(_mm_castps_si128(mask), dec));
+			}
+
+			_mm_storeu_ps(&alpha_curr[s], best);
+			min_v = _mm_min_ps(min_v, best);
+
+			//Extract decision bit-planes from the sign bits
+			for(int b=0 ; b < n_planes ; ++b) {
+				uint32_t bits = _mm_movemask_ps(
+						_mm_castsi128_ps(_mm_slli_epi32(dec, 31-b)));
+				trace_k[b*n_words + s/32] |= bits << (s%32);
+			}
+		}
+
+		//Min-reduction
+		min_v = _mm_min_ps(min_v, _mm_shuffle_ps(min_v, min_v, _MM_SHUFFLE(1,0,3,2)));
+		min_v = _mm_min_ps(min_v, _mm_shuffle_ps(min_v, min_v, _MM_SHUFFLE(2,3,0,1)));
+		min_metric = _mm_cvtss_f32(min_v);
+#endif
+
+		//Scalar fallback (and remaining states)
+		for( ; s < S ; ++s) {
+			float best = cand[s];
+			uint32_t dec = 0;
+
+			for(int j=1 ; j < F ; ++j) {
+				bool mask = cand[j*S + s] < best;
+				best = mask ? cand[j*S + s] : best;
+				dec = mask ? j : dec;
+			}
+
+			alpha_curr[s] = best;
+			min_metric = std::min(min_metric, best);
+
+			for(int b=0 ; b < n_planes ; ++b) {
+				trace_k[b*n_words + s/32] |= ((dec >> b) & 1) << (s%32);
+			}
+		}
+
+		//Metrics normalization
+		for(s=0 ; s < S ; ++s) {
+			alpha_curr[s] -= min_metric;
+		}
+
+		//At this point, current path metrics becomes previous path metrics
+		alpha_prev.swap(alpha_curr);
+	}
+	PERF_ELAPSED(d_perf, PERF_ACS, acs_start);
+
+	//If final state was specified
+	if(SK != -1) {
+		tb_state = SK;
+	}
+	else{
+		//at this point, alpha_prev contains the path metrics of states after time K
+		tb_state = (int)(min_element(alpha_prev.begin(), alpha_prev.end()) - alpha_prev.begin());
+	}
+
+	//Traceback
+	PERF_SCOPE(d_perf, PERF_TRACEBACK);
+	for(int k=K-1 ; k >= 0 ; --k) {
+		const uint32_t *trace_k = &trace[k*trace_stride];
+
+		//Retrieve previous input index from the decision bit-planes
+		pidx = 0;
+		for(int b=0 ; b < n_planes ; ++b) {
+			pidx |= ((trace_k[b*n_words + tb_state/32] >> (tb_state%32)) & 1) << b;
+		}
+
+		//Output previous input
+		out[k] = (unsigned int) d_PI[tb_state][pidx];
+
+		//Update tb_state with the previous state on the shortest path
+		tb_state = d_PS[tb_state][pidx];
+	}
 }
 
 void
@@ -179,3 +429,252 @@ viterbi::viterbi_algorithm(int I, int S, int O, const std::vector<int> &NS,
 		tb_state = PS[tb_state][pidx];
 	}
 }
+
+//! FNV-1a parameters, for the hashes of decoded prefixes in list Viterbi.
+static const uint64_t LIST_HASH_INIT = 14695981039346656037ULL;
+static const uint64_t LIST_HASH_PRIME = 1099511628211ULL;
+
+template<class VISIT>
+int
+viterbi::viterbi_algorithm_list_core(int K, int S0, int SK, const float *in,
+		int L, VISIT &visit)
+{
+	const float inf = std::numeric_limits<float>::infinity();
+	const size_t trace_stride = (size_t)d_S*L;
+
+	//Path metrics and trace are indexed by s*L + rank
+	std::vector<float> alpha_prev(trace_stride, inf);
+	std::vector<float> alpha_curr(trace_stride);
+	std::vector<int> trace(K*trace_stride, 0);
+	std::vector<int> head;
+	std::vector<std::pair<float, int> > cand;
+	//Hashes of the decoded prefixes (only used if S0 is unknown)
+	const bool dedup = (S0 == -1);
+	std::vector<uint64_t> hash_prev, hash_curr;
+	std::vector<unsigned int> seen;
+	float min_metric;
+	int n_visited = 0;
+
+	if(L < 1) {
+		throw std::runtime_error("L must be strictly positive");
+	}
+
+	PERF_ADD(d_perf, PERF_CALLS, 1);
+	PERF_ADD(d_perf, PERF_STEPS, K);
+	PERF_ADD(d_perf, PERF_BYTES_ALLOCATED,
+			K*trace_stride*sizeof(int) + 2*trace_stride*sizeof(float));
+
+	//If initial state was specified
+	if(S0 != -1) {
+		alpha_prev[S0*L] = 0.0;
+	}
+	else {
+		//Paths starting from different states may then yield the same
+		//decoded sequence, only the best of them is kept
+		hash_prev.assign(trace_stride, LIST_HASH_INIT);
+		hash_curr.resize(trace_stride);
+
+		for(int s=0 ; s < d_S ; ++s) {
+			alpha_prev[s*L] = 0.0;
+		}
+	}
+
+	PERF_TIMESTAMP(acs_start);
+	for(int k=0 ; k < K ; ++k) {
+		const float *in_k = in + k*d_O;
+		int *trace_k = &trace[k*trace_stride];
+		std::vector<int>::const_iterator ordered_OS_it = d_ordered_OS.begin();
+
+		min_metric = inf;
+
+		for(int s=0 ; s < d_S ; ++s) {
+			const std::vector<int> &PS_s = d_PS[s];
+			const int F = PS_s.size();
+			float *alpha_s = &alpha_curr[s*L];
+			int *trace_s = &trace_k[s*L];
+			uint64_t *hash_s = dedup ? &hash_curr[s*L] : NULL;
+
+			//Merge the sorted lists of the previous states: head[j] is the
+			//rank of the next path of PS[s][j] to be considered
+			head.assign(F, 0);
+
+			for(int r=0 ; r < L ; ) {
+				float best = inf;
+				int best_j = -1;
+
+				for(int j=0 ; j < F ; ++j) {
+					if(head[j] < L) {
+						float metric = alpha_prev[PS_s[j]*L + head[j]]
+							+ in_k[*(ordered_OS_it + j)];
+
+						if(metric < best) {
+							best = metric;
+							best_j = j;
+						}
+					}
+				}
+
+				//Less than L paths reach s
+				if(best_j < 0) {
+					std::fill(alpha_s + r, alpha_s + L, inf);
+					break;
+				}
+
+				if(dedup) {
+					uint64_t h = (hash_prev[PS_s[best_j]*L + head[best_j]]
+							^ (d_PI[s][best_j] + 1)) * LIST_HASH_PRIME;
+
+					//Worse path for an already kept decoded sequence
+					if(std::find(hash_s, hash_s + r, h) != hash_s + r) {
+						++head[best_j];
+						continue;
+					}
+					hash_s[r] = h;
+				}
+
+				alpha_s[r] = best;
+				trace_s[r] = best_j*L + head[best_j];
+				++head[best_j];
+				++r;
+			}
+
+			min_metric = std::min(min_metric, alpha_s[0]);
+			ordered_OS_it += F;
+		}
+
+		//Metrics normalization (on the best paths)
+		for(size_t n=0 ; n < trace_stride ; ++n) {
+			alpha_curr[n] -= min_metric;
+		}
+
+		//At this point, current path metrics becomes previous path metrics
+		alpha_prev.swap(alpha_curr);
+		hash_prev.swap(hash_curr);
+	}
+	PERF_ELAPSED(d_perf, PERF_ACS, acs_start);
+
+	//Candidate paths, as (metric, s*L + rank), sorted by increasing metric
+	if(SK != -1) {
+		for(int r=0 ; r < L ; ++r) {
+			cand.push_back(std::make_pair(alpha_prev[SK*L + r], SK*L + r));
+		}
+	}
+	else {
+		for(size_t n=0 ; n < trace_stride ; ++n) {
+			cand.push_back(std::make_pair(alpha_prev[n], (int)n));
+		}
+		std::sort(cand.begin(), cand.end());
+	}
+
+	//Traceback
+	PERF_SCOPE(d_perf, PERF_TRACEBACK);
+	std::vector<unsigned int> seq(K);
+
+	for(size_t c=0 ; c < cand.size() && n_visited < L ; ++c) {
+		int tb_state = cand[c].second / L;
+		int tb_rank = cand[c].second % L;
+		bool duplicate = false;
+
+		if(cand[c].first == inf) {
+			break;
+		}
+
+		for(int k=K-1 ; k >= 0 ; --k) {
+			int t = trace[k*trace_stride + tb_state*L + tb_rank];
+			int pidx = t / L;
+
+			//Output previous input
+			seq[k] = (unsigned int) d_PI[tb_state][pidx];
+
+			//Update tb_state and tb_rank with the previous path
+			tb_rank = t % L;
+			tb_state = d_PS[tb_state][pidx];
+		}
+
+		//Paths only differing by their initial state yield the same sequence
+		for(size_t n=0 ; n < seen.size() && !duplicate ; n += K) {
+			duplicate = std::equal(seq.begin(), seq.end(), seen.begin() + n);
+		}
+		if(duplicate) {
+			continue;
+		}
+		seen.insert(seen.end(), seq.begin(), seq.end());
+
+		if(visit(&seq[0], cand[c].first - cand[0].first)) {
+			return n_visited + 1;
+		}
+		++n_visited;
+	}
+
+	return n_visited;
+}
+
+//! Copies every candidate of the list Viterbi algorithm.
+struct list_viterbi_output
+{
+	int K;
+	unsigned int *out;
+	float *metrics;
+	int n;
+
+	bool operator()(const unsigned int *seq, float metric)
+	{
+		std::copy(seq, seq + K, out + n*K);
+		metrics[n++] = metric;
+
+		return false;
+	}
+};
+
+//! Stops the list Viterbi algorithm on the first candidate passing a CRC.
+struct list_viterbi_crc_check
+{
+	int K;
+	const crc &check;
+	size_t n_checked;
+	unsigned int *out;
+	bool valid;
+	int n;
+
+	bool operator()(const unsigned int *seq, float /*metric*/)
+	{
+		valid = check.check(seq, n_checked);
+
+		//Keep the best candidate if none passes the CRC
+		if(valid || n++ == 0) {
+			std::copy(seq, seq + K, out);
+		}
+
+		return valid;
+	}
+};
+
+int
+viterbi::viterbi_algorithm_list(int K, int S0, int SK, const float *in,
+		int L, unsigned int *out, float *metrics)
+{
+	list_viterbi_output visit = {K, out, metrics, 0};
+
+	return viterbi_algorithm_list_core(K, S0, SK, in, L, visit);
+}
+
+int
+viterbi::viterbi_algorithm_list_crc(int K, int S0, int SK, const float *in,
+		int L, const crc &check, size_t n_checked, unsigned int *out)
+{
+	if(d_I != 2) {
+		throw std::runtime_error("CRC-aided decoding requires binary inputs");
+	}
+
+	if(n_checked == 0) {
+		n_checked = K;
+	}
+	else if(n_checked > (size_t)K) {
+		throw std::runtime_error("n_checked must not exceed K");
+	}
+
+	list_viterbi_crc_check visit = {K, check, n_checked, out, false, 0};
+	int n_visited = viterbi_algorithm_list_core(K, S0, SK, in, L, visit);
+
+	return visit.valid ? n_visited - 1 : -1;
+}
@@ -22,11 +22,16 @@
 #define INCLUDED_VITERBI__H
 
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <limits>
 #include <vector>
 #include <stdexcept>
 
+#include "crc.h"
+#include "perf_counters.h"
+#include "puncturing_pattern.h"
+
 /*! A maximum likelihood decoder.
  *
  * This block implements the Viterbi algorithm in its classical form, as
@@ -67,9 +72,81 @@ class viterbi
 		 */
         std::vector<int> d_ordered_OS;
 
+		/* Number of branches reaching each state when it is the same for
+		 * every state (uniform fan-in) and at least 2, 0 otherwise.
+		 */
+		int d_fanin;
+		/* Previous states, transposed for the vectorized ACS:
+		 * d_acs_PS[j*S+s] = PS[s][j] (only valid if d_fanin != 0).
+		 */
+		std::vector<int> d_acs_PS;
+		/* Ordered output symbols, transposed for the vectorized ACS:
+		 * d_acs_OS[j*S+s] = d_ordered_OS[s*d_fanin+j] (only valid if
+		 * d_fanin != 0).
+		 */
+		std::vector<int> d_acs_OS;
+		//! Whether viterbi_algorithm() uses the vectorized ACS engine.
+		bool d_vectorized;
+
+		/* Performance counters (with the generic implementation, traceback
+		 * is counted as ACS).
+		 */
+		perf_counters d_perf;
+
 		//! Generates PS and PI tables.
 		void generate_PS_PI();
 
+		//! Generates d_fanin, d_acs_PS and d_acs_OS.
+		void generate_acs_tables();
+
+		/*! Viterbi algorithm with a vectorized add-compare-select.
+		 *
+		 * Only valid for trellises with uniform fan-in. Compare and select
+		 * are performed with masks over several states at once, decisions
+		 * are extracted from the masks as bit-planes, and the minimum path
+		 * metric used for normalization is obtained by a vector
+		 * min-reduction. A scalar fallback is used if SSE2 is not
+		 * available. Output is identical to the generic implementation.
+		 *
+		 * \param K Length of a block of data.
+		 * \param S0 Initial state of the encoder (set to -1 if unknown).
+		 * \param SK Final state of the encoder (set to -1 if unknown).
+		 * \param metrics Functor returning a pointer to the branch metrics
+		 *  of a time index (const float *metrics(int k)).
+		 * \param out Output decoded sequence.
+		 */
+		template<class METRICS>
+		void viterbi_algorithm_acs(int K, int S0, int SK,
+				METRICS &metrics, unsigned int *out);
+
+		/*! Parallel list Viterbi algorithm.
+		 *
+		 * The forward pass keeps, for every state, the L best paths
+		 * reaching it (sorted by path metric), and stores for each of them
+		 * the index of its incoming branch in d_PS/d_PI and its rank among
+		 * the paths of the previous state. If S0 is unknown, paths starting
+		 * from different states may yield the same decoded sequence: only the
+		 * best of them is kept, duplicates being detected during the merge
+		 * with 64-bit hashes of the decoded prefixes. Candidates are then
+		 * traced back from the best to the worst.
+		 *
+		 * \param K Length of a block of data.
+		 * \param S0 Initial state of the encoder (set to -1 if unknown).
+		 * \param SK Final state of the encoder (set to -1 if unknown).
+		 * \param in Input branch metrics for the algorithm.
+		 * \param L Number of paths kept per state.
+		 * \param visit Functor called on each candidate, best first:
+		 *  bool visit(const unsigned int *seq, float metric), seq being the
+		 *  decoded sequence (size: K) and metric its path metric relative to
+		 *  the best candidate. Candidates stop being traced back as soon as
+		 *  it returns true.
+		 *
+		 * \return The number of visited candidates.
+		 */
+		template<class VISIT>
+		int viterbi_algorithm_list_core(int K, int S0, int SK,
+				const float *in, int L, VISIT &visit);
+
 	public:
 		//! Default constructor.
 		viterbi();
@@ -88,6 +165,8 @@ class viterbi
 				const std::vector<int> &NS,
 				const std::vector<int> &OS);
 
+		virtual ~viterbi() {}
+
 		/*! Actual Viterbi algorithm implementation.
 		 *
 		 * \param K Length of a block of data.
@@ -96,7 +175,7 @@ class viterbi
 		 * \param in Input branch metrics for the algorithm.
 		 * \param out Output decoded sequence.
 		 */
-		void viterbi_algorithm(int K, int S0, int SK,
+		virtual void viterbi_algorithm(int K, int S0, int SK,
 				const float *in, unsigned int *out);
 
 		/*! Actual Viterbi algorithm implementation.
@@ -126,6 +205,82 @@ class viterbi
 				int K, int S0, int SK,
 				const float *in, unsigned int *out);
 
+		/*! Viterbi algorithm for a punctured code.
+		 *
+		 * Branch metrics of each time index are computed on the fly from
+		 * the soft inputs, skipping punctured positions, so that the d_O*K
+		 * metrics buffer is not built (except for trellises that cannot use
+		 * the vectorized ACS engine).
+		 *
+		 * \param K Length of a block of data.
+		 * \param S0 Initial state of the encoder (set to -1 if unknown).
+		 * \param SK Final state of the encoder (set to -1 if unknown).
+		 * \param llr Log-likelihood ratios of the transmitted bits (size:
+		 *  pattern.get_n_soft(K)).
+		 * \param pattern Puncturing pattern (d_O must be 2^pattern.get_n()).
+		 * \param out Output decoded sequence.
+		 */
+		void viterbi_algorithm_punctured(int K, int S0, int SK,
+				const float *llr, const puncturing_pattern &pattern,
+				unsigned int *out);
+
+		/*! List Viterbi algorithm, returning the L best decoded sequences.
+		 *
+		 * The L best paths are kept for every state, which yields in one
+		 * pass the L most likely distinct decoded sequences (fewer if the
+		 * trellis does not have that many paths). The first one is the
+		 * output of viterbi_algorithm().
+		 *
+		 * \param K Length of a block of data.
+		 * \param S0 Initial state of the encoder (set to -1 if unknown).
+		 * \param SK Final state of the encoder (set to -1 if unknown).
+		 * \param in Input branch metrics for the algorithm.
+		 * \param L Number of candidates.
+		 * \param out Decoded sequences, best first (size: L*K).
+		 * \param metrics Path metric of each sequence, relative to the best
+		 *  one (size: L).
+		 *
+		 * \return The number of sequences written to out.
+		 */
+		int viterbi_algorithm_list(int K, int S0, int SK, const float *in,
+				int L, unsigned int *out, float *metrics);
+
+		/*! CRC-aided list Viterbi algorithm.
+		 *
+		 * Candidates of viterbi_algorithm_list() are traced back from the
+		 * best one, and checked until one passes the CRC.
+		 *
+		 * \param K Length of a block of data.
+		 * \param S0 Initial state of the encoder (set to -1 if unknown).
+		 * \param SK Final state of the encoder (set to -1 if unknown).
+		 * \param in Input branch metrics for the algorithm.
+		 * \param L Maximum number of candidates.
+		 * \param check CRC of the frame.
+		 * \param n_checked Number of decoded bits covered by check, CRC
+		 *  included (e.g. excluding tail bits), or 0 for all K bits.
+		 * \param out Output decoded sequence: the first candidate passing
+		 *  the CRC, or the best candidate if none does (size: K).
+		 *
+		 * \return The index of the candidate passing the CRC (0 for the
+		 *  output of viterbi_algorithm()), or -1 if none does.
+		 */
+		int viterbi_algorithm_list_crc(int K, int S0, int SK, const float *in,
+				int L, const crc &check, size_t n_checked, unsigned int *out);
+
+		/*! Enables or disables the vectorized ACS engine.
+		 *
+		 * It is enabled by default, and only used for trellises where
+		 * every state has the same number of incoming branches.
+		 *
+		 * \param vectorized true to enable the vectorized ACS engine.
+		 */
+		void set_vectorized(bool vectorized) { d_vectorized = vectorized; }
+		//! Getter for d_vectorized.
+		bool get_vectorized() { return d_vectorized; }
+
+		//! Getter for d_perf.
+		perf_counters& get_perf_counters() { return d_perf; }
+
 		//! Getter for d_I.
 		int get_I() { return d_I; }
 		//! Getter for d_S.